@@ -0,0 +1,349 @@
+#ifndef CompressedGraph_H
+#define CompressedGraph_H
+
+#include <vector>
+#include <unordered_map>
+#include <stdexcept>
+#include <utility>
+#include <climits>
+#include <cstdint>
+#include "Heap.h"
+#include "CsrGraph.h"
+
+// Read-only snapshot that keeps the adjacency as a byte stream instead of
+// 32-bit ids, for graphs whose CsrGraph would not fit in memory. The out-list
+// of vertex i starts at data[offsets[i]] and holds
+//     degree, first neighbour - i (zigzag), gap to the next neighbour, ...
+// as LEB128 varints; neighbour lists are sorted, so the gaps are small (and
+// smaller still after CsrGraph::reorder). Weighted graphs follow every
+// neighbour with its weight (zigzag), unweighted ones store no weights at all.
+// Lists are only readable front to back through a NeighborCursor:
+//     for(auto c = g.getNeighbors(u); c.next(); ){ c.neighbor(); c.weight(); }
+template <typename T>
+class CompressedGraph {
+    private:
+        std::vector<T> vertices;
+        std::unordered_map<T, uint32_t> vertexId;
+        std::vector<std::size_t> offsets;
+        std::vector<uint8_t> data;
+        std::size_t edgeCount;
+        bool isDirected;
+        bool isWeighted;
+        bool isNegativelyWeighted;
+
+        static void writeVarint(std::vector<uint8_t> &out, uint64_t value){
+            while(value >= 0x80){
+                out.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(value));
+        }
+        static uint64_t readVarint(const uint8_t *&pos){
+            uint64_t value = *pos++;
+            if(value < 0x80){
+                return value; // most gaps fit in one byte
+            }
+            value &= 0x7f;
+            for(unsigned shift = 7; ; shift += 7){
+                uint64_t byte = *pos++;
+                value |= (byte & 0x7f) << shift;
+                if(byte < 0x80){
+                    return value;
+                }
+            }
+        }
+        static uint64_t zigzag(int64_t value) { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); }
+        static int64_t unzigzag(uint64_t value) { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+
+        void getDistanceBFS(uint32_t start, std::vector<int> &distance) const;
+        template <typename Heap>
+        void runDijkstra(uint32_t start, std::vector<int> &distance, Heap &pq) const;
+        void getDistanceDijkstra(uint32_t start, std::vector<int> &distance, HeapType heap) const;
+        void getDistanceBellmanFord(uint32_t start, std::vector<int> &distance) const;
+
+        std::vector<std::pair<T, int>> toDistanceVector(const std::vector<int> &distance) const;
+
+    public:
+        // Decodes one out-list. Not valid past the lifetime of its graph.
+        class NeighborCursor {
+            private:
+                const uint8_t *pos;
+                std::size_t remaining;
+                uint32_t current;
+                int currentWeight;
+                bool first;
+                bool isWeighted;
+
+            public:
+                NeighborCursor(const uint8_t *pos, uint32_t source, bool isWeighted)
+                    : pos(pos), current(source), currentWeight(1), first(true), isWeighted(isWeighted) {
+                    remaining = static_cast<std::size_t>(readVarint(this->pos));
+                }
+
+                std::size_t size() const { return remaining; } // neighbours not yet read
+                // moves to the next neighbour, false once the list is exhausted
+                bool next(){
+                    if(remaining == 0){
+                        return false;
+                    }
+                    --remaining;
+                    if(first){
+                        current = static_cast<uint32_t>(static_cast<int64_t>(current) + unzigzag(readVarint(pos)));
+                        first = false;
+                    }
+                    else{
+                        current += static_cast<uint32_t>(readVarint(pos));
+                    }
+                    if(isWeighted){
+                        currentWeight = static_cast<int>(unzigzag(readVarint(pos)));
+                    }
+                    return true;
+                }
+                uint32_t neighbor() const { return current; }
+                int weight() const { return currentWeight; }
+        };
+
+        CompressedGraph() : offsets(1, 0), edgeCount(0), isDirected(false), isWeighted(false), isNegativelyWeighted(false) {}
+        // keeps the snapshot's vertex ids
+        explicit CompressedGraph(const CsrGraph<T> &graph);
+
+        std::size_t getVertexCount() const { return vertices.size(); }
+        std::size_t getEdgeCount() const { return edgeCount; } // number of stored arcs
+        bool directed() const { return isDirected; }
+        bool weighted() const { return isWeighted; }
+        bool hasVertex(const T& v) const { return vertexId.find(v) != vertexId.end(); }
+        uint32_t getId(const T& v) const;
+        const T& getVertex(uint32_t id) const { return vertices[id]; }
+        const std::vector<T>& getVertices() const { return vertices; }
+        std::size_t getDegree(uint32_t id) const{
+            const uint8_t *pos = data.data() + offsets[id];
+            return static_cast<std::size_t>(readVarint(pos));
+        }
+        NeighborCursor getNeighbors(uint32_t id) const { return NeighborCursor(data.data() + offsets[id], id, isWeighted); }
+        // bytes held by the adjacency stream and its offsets
+        std::size_t getEncodedBytes() const { return data.size() + offsets.size() * sizeof(std::size_t); }
+
+        std::vector<T> getBFS(T start) const;
+        std::vector<T> getDFS(T start) const;
+        std::vector<std::pair<T, int>> getSinglePointShortestPath(T start, HeapType heap = HeapType::LazyBinary) const;
+};
+
+template <typename T>
+CompressedGraph<T>::CompressedGraph(const CsrGraph<T> &graph)
+    : vertices(graph.getVertices()), edgeCount(graph.getEdgeCount()), isDirected(graph.directed()), isWeighted(graph.weighted()), isNegativelyWeighted(false) {
+    const std::size_t n = vertices.size();
+    vertexId.reserve(n);
+    for(uint32_t id = 0; id < n; ++id){
+        vertexId[vertices[id]] = id;
+    }
+
+    const std::vector<std::size_t> &csrOffsets = graph.getOffsets();
+    const std::vector<uint32_t> &neighbors = graph.getNeighbors();
+    const std::vector<int> &weights = graph.getWeights();
+    offsets.resize(n + 1);
+    data.reserve(n + neighbors.size() * (isWeighted ? 3 : 2));
+    for(uint32_t u = 0; u < n; ++u){
+        offsets[u] = data.size();
+        writeVarint(data, csrOffsets[u + 1] - csrOffsets[u]);
+        // CsrGraph lists are already sorted by id
+        int64_t previous = u;
+        for(std::size_t e = csrOffsets[u]; e < csrOffsets[u + 1]; ++e){
+            if(e == csrOffsets[u]){
+                writeVarint(data, zigzag(static_cast<int64_t>(neighbors[e]) - previous));
+            }
+            else{
+                writeVarint(data, static_cast<uint64_t>(neighbors[e] - previous));
+            }
+            previous = neighbors[e];
+            if(isWeighted){
+                writeVarint(data, zigzag(weights[e]));
+                if(weights[e] < 0){
+                    isNegativelyWeighted = true;
+                }
+            }
+        }
+    }
+    offsets[n] = data.size();
+    data.shrink_to_fit();
+}
+
+template <typename T>
+uint32_t CompressedGraph<T>::getId(const T& v) const{
+    auto it = vertexId.find(v);
+    if(it == vertexId.end()){
+        throw std::invalid_argument("Vertex not found");
+    }
+    return it->second;
+}
+
+template <typename T>
+std::vector<T> CompressedGraph<T>::getBFS(T start) const{
+    uint32_t source = getId(start);
+    std::vector<T> bfs;
+    std::vector<char> visited(vertices.size(), 0);
+    std::vector<uint32_t> q;
+    q.reserve(vertices.size());
+    q.push_back(source);
+    visited[source] = 1;
+    for(std::size_t head = 0; head < q.size(); ++head){
+        // Decoding a list is a chain of dependent loads, which stops the CPU
+        // from running ahead into the next lists the way it does over a
+        // CsrGraph; fetch them (offset first, then bytes) a few entries early.
+        if(head + 32 < q.size()){
+            __builtin_prefetch(&offsets[q[head + 32]]);
+        }
+        if(head + 16 < q.size()){
+            __builtin_prefetch(data.data() + offsets[q[head + 16]]);
+        }
+        uint32_t node = q[head];
+        bfs.push_back(vertices[node]);
+        for(auto c = getNeighbors(node); c.next(); ){
+            uint32_t ngb = c.neighbor();
+            if(!visited[ngb]){
+                visited[ngb] = 1;
+                q.push_back(ngb);
+            }
+        }
+    }
+    return bfs;
+}
+
+template <typename T>
+std::vector<T> CompressedGraph<T>::getDFS(T start) const{
+    uint32_t source = getId(start);
+    std::vector<T> dfs;
+    std::vector<char> visited(vertices.size(), 0);
+    std::vector<uint32_t> s;
+    s.push_back(source);
+    visited[source] = 1;
+    while(!s.empty()){
+        uint32_t node = s.back();
+        s.pop_back();
+        dfs.push_back(vertices[node]);
+        for(auto c = getNeighbors(node); c.next(); ){
+            if(!visited[c.neighbor()]){
+                visited[c.neighbor()] = 1;
+                s.push_back(c.neighbor());
+            }
+        }
+    }
+    return dfs;
+}
+
+template <typename T>
+std::vector<std::pair<T, int>> CompressedGraph<T>::getSinglePointShortestPath(T start, HeapType heap) const{
+    uint32_t source = getId(start);
+    std::vector<int> distance(vertices.size(), INT_MAX);
+    if(!isWeighted){
+        getDistanceBFS(source, distance);
+    }
+    else if(!isNegativelyWeighted){
+        getDistanceDijkstra(source, distance, heap);
+    }
+    else{
+        getDistanceBellmanFord(source, distance);
+    }
+    return toDistanceVector(distance);
+}
+
+template <typename T>
+void CompressedGraph<T>::getDistanceBFS(uint32_t start, std::vector<int> &distance) const{
+    std::vector<uint32_t> q;
+    q.reserve(vertices.size());
+    q.push_back(start);
+    distance[start] = 0;
+    for(std::size_t head = 0; head < q.size(); ++head){
+        // lists fetched ahead as in getBFS
+        if(head + 32 < q.size()){
+            __builtin_prefetch(&offsets[q[head + 32]]);
+        }
+        if(head + 16 < q.size()){
+            __builtin_prefetch(data.data() + offsets[q[head + 16]]);
+        }
+        uint32_t node = q[head];
+        for(auto c = getNeighbors(node); c.next(); ){
+            uint32_t ngb = c.neighbor();
+            if(distance[ngb] == INT_MAX){
+                distance[ngb] = distance[node] + 1;
+                q.push_back(ngb);
+            }
+        }
+    }
+}
+
+template <typename T>
+template <typename Heap>
+void CompressedGraph<T>::runDijkstra(uint32_t start, std::vector<int> &distance, Heap &pq) const{
+    distance[start] = 0;
+    pq.push(0, start);
+    while(!pq.empty()){
+        auto [dis, node] = pq.pop();
+        if(dis > distance[node]){
+            continue; // stale entry
+        }
+        for(auto c = getNeighbors(node); c.next(); ){
+            uint32_t ngb = c.neighbor();
+            if(dis + c.weight() < distance[ngb]){
+                distance[ngb] = dis + c.weight();
+                pq.push(distance[ngb], ngb);
+            }
+        }
+    }
+}
+
+template <typename T>
+void CompressedGraph<T>::getDistanceDijkstra(uint32_t start, std::vector<int> &distance, HeapType heap) const{
+    switch(heap){
+        case HeapType::IndexedDary: {
+            IndexedDaryHeap<4> pq(vertices.size());
+            runDijkstra(start, distance, pq);
+            break;
+        }
+        case HeapType::Radix: {
+            RadixHeap pq;
+            runDijkstra(start, distance, pq);
+            break;
+        }
+        default: {
+            LazyBinaryHeap pq(vertices.size());
+            runDijkstra(start, distance, pq);
+            break;
+        }
+    }
+}
+
+template <typename T>
+void CompressedGraph<T>::getDistanceBellmanFord(uint32_t start, std::vector<int> &distance) const{
+    distance[start] = 0;
+    std::size_t n = vertices.size();
+    for(std::size_t i = 0; i < n; ++i){
+        bool relaxed = false;
+        for(uint32_t u = 0; u < n; ++u){
+            if(distance[u] == INT_MAX){
+                continue;
+            }
+            for(auto c = getNeighbors(u); c.next(); ){
+                if(distance[u] + c.weight() < distance[c.neighbor()]){
+                    distance[c.neighbor()] = distance[u] + c.weight();
+                    relaxed = true;
+                }
+            }
+        }
+        if(!relaxed){
+            return;
+        }
+    }
+    throw std::runtime_error("Graph has a negative weight cycle");
+}
+
+template <typename T>
+std::vector<std::pair<T, int>> CompressedGraph<T>::toDistanceVector(const std::vector<int> &distance) const{
+    std::vector<std::pair<T, int>> disVector;
+    disVector.reserve(vertices.size());
+    for(uint32_t id = 0; id < vertices.size(); ++id){
+        disVector.push_back({vertices[id], distance[id] == INT_MAX ? -1 : distance[id]});
+    }
+    return disVector;
+}
+
+#endif
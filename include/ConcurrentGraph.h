@@ -0,0 +1,118 @@
+#ifndef ConcurrentGraph_H
+#define ConcurrentGraph_H
+
+#include <memory>
+#include <mutex>
+#include <deque>
+#include <utility>
+#include <stdexcept>
+#include <cstdint>
+#include "Graph.h"
+
+// A Graph that keeps serving queries while it is being updated. Readers take
+// an immutable snapshot and query it with no coordination with writers:
+//     auto g = live.snapshot();
+//     g->getShortestPath(a, b);
+// Writers apply whole batches to a private copy of the newest version and
+// publish it with one atomic pointer swap:
+//     live.update([&](Graph<int> &g){ for(...) g.addEdge(u, v, w); });
+// A snapshot stays valid for as long as the reader holds it. The graph itself
+// only keeps the newest retainedVersions versions reachable by number; an old
+// version is freed when its last reader lets go of it.
+//
+// Each update copies the graph once, so batch updates rather than publishing
+// every edge on its own.
+template <typename T>
+class ConcurrentGraph {
+    public:
+        typedef std::shared_ptr<const Graph<T>> Snapshot;
+
+    private:
+        struct Version {
+            uint64_t number;
+            Graph<T> graph;
+            Version(uint64_t number, const Graph<T> &graph) : number(number), graph(graph) {}
+            Version(uint64_t number, Graph<T> &&graph) : number(number), graph(std::move(graph)) {}
+        };
+
+        std::shared_ptr<const Version> head; // only touched through std::atomic_load/atomic_store
+        std::mutex writerMutex; // one batch at a time
+        mutable std::mutex historyMutex;
+        std::deque<std::shared_ptr<const Version>> history; // oldest first, head last
+        std::size_t retainedVersions;
+
+        void publish(std::shared_ptr<const Version> next){
+            {
+                std::lock_guard<std::mutex> lock(historyMutex);
+                history.push_back(next);
+                while(history.size() > retainedVersions){
+                    history.pop_front();
+                }
+            }
+            std::atomic_store(&head, std::move(next));
+        }
+
+        static Snapshot toSnapshot(const std::shared_ptr<const Version> &version){
+            // shares ownership of the version, points at its graph
+            return Snapshot(version, &version->graph);
+        }
+
+    public:
+        ConcurrentGraph(bool isDirected = false, bool isWeighted = false, std::size_t retainedVersions = 4)
+            : ConcurrentGraph(Graph<T>(isDirected, isWeighted), retainedVersions) {}
+        explicit ConcurrentGraph(Graph<T> initial, std::size_t retainedVersions = 4) : retainedVersions(retainedVersions){
+            if(retainedVersions == 0){
+                throw std::invalid_argument("At least one version must be retained");
+            }
+            publish(std::make_shared<const Version>(1, std::move(initial)));
+        }
+        ConcurrentGraph(const ConcurrentGraph&) = delete;
+        ConcurrentGraph& operator=(const ConcurrentGraph&) = delete;
+
+        // the newest published version
+        Snapshot snapshot() const { return toSnapshot(std::atomic_load(&head)); }
+        // a retained older version, or nullptr once it has been evicted
+        Snapshot snapshot(uint64_t version) const;
+        uint64_t getVersion() const { return std::atomic_load(&head)->number; }
+
+        // Runs batch(Graph<T>&) on a copy of the newest version and publishes
+        // the result as the next version, which is returned. If batch throws,
+        // nothing is published and the exception propagates.
+        template <typename Batch>
+        uint64_t update(Batch &&batch);
+
+        // single-mutation updates, each one a full version
+        uint64_t addEdge(T u, T v, int w = 1) { return update([&](Graph<T> &g){ g.addEdge(u, v, w); }); }
+        uint64_t removeEdge(T u, T v) { return update([&](Graph<T> &g){ g.removeEdge(u, v); }); }
+        uint64_t addVertex(T v) { return update([&](Graph<T> &g){ g.addVertex(v); }); }
+        uint64_t removeVertex(T v) { return update([&](Graph<T> &g){ g.removeVertex(v); }); }
+};
+
+template <typename T>
+typename ConcurrentGraph<T>::Snapshot ConcurrentGraph<T>::snapshot(uint64_t version) const{
+    std::lock_guard<std::mutex> lock(historyMutex);
+    if(history.empty() || version < history.front()->number || version > history.back()->number){
+        return nullptr;
+    }
+    // numbers are consecutive, so the position follows from the oldest one
+    return toSnapshot(history[version - history.front()->number]);
+}
+
+template <typename T>
+template <typename Batch>
+uint64_t ConcurrentGraph<T>::update(Batch &&batch){
+    std::lock_guard<std::mutex> lock(writerMutex);
+    std::shared_ptr<const Version> current = std::atomic_load(&head);
+
+    std::shared_ptr<Version> next;
+    {
+        // readers may be filling the current version's caches while we copy it
+        std::lock_guard<std::mutex> cacheLock(current->graph.cacheMutex.mutex);
+        next = std::make_shared<Version>(current->number + 1, current->graph);
+    }
+    batch(next->graph);
+    publish(std::move(next));
+    return current->number + 1;
+}
+
+#endif
@@ -0,0 +1,239 @@
+#ifndef ConnectivityIndex_H
+#define ConnectivityIndex_H
+
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+#include "DisjointSet.h"
+
+// InsertOnly keeps a union-find and falls back to a full rebuild after any
+// deletion. Dynamic keeps explicit component labels: inserts merge the smaller
+// component into the larger one, and a deletion searches from both endpoints
+// in lock step, so only the smaller side of a split is ever walked.
+enum class ConnectivityMode { None, InsertOnly, Dynamic };
+
+// (Weakly) connected components over dense vertex ids, kept up to date by the
+// owning graph. Edges are counted with multiplicity, so a directed graph can
+// report u->v and v->u separately.
+class ConnectivityIndex {
+    private:
+        ConnectivityMode mode;
+        std::vector<bool> present;
+        std::size_t vertexCount;
+        bool stale;
+
+        // InsertOnly
+        DisjointSet dsu;
+
+        // Dynamic
+        std::vector<uint32_t> component;            // vertex -> label
+        std::vector<uint32_t> position;             // vertex -> index in members[label]
+        std::vector<std::vector<uint32_t>> members; // label -> vertices
+        std::vector<uint32_t> freeLabels;
+        std::vector<std::unordered_map<uint32_t, int>> links; // undirected edge multiplicities
+        std::size_t components;
+
+        uint32_t newLabel(){
+            if(!freeLabels.empty()){
+                uint32_t label = freeLabels.back();
+                freeLabels.pop_back();
+                return label;
+            }
+            members.push_back({});
+            return static_cast<uint32_t>(members.size() - 1);
+        }
+
+        void detach(uint32_t v){
+            std::vector<uint32_t> &list = members[component[v]];
+            uint32_t last = list.back();
+            list[position[v]] = last;
+            position[last] = position[v];
+            list.pop_back();
+        }
+
+        void attach(uint32_t v, uint32_t label){
+            component[v] = label;
+            position[v] = static_cast<uint32_t>(members[label].size());
+            members[label].push_back(v);
+        }
+
+        void grow(uint32_t id){
+            if(id < present.size()){
+                return;
+            }
+            present.resize(id + 1, false);
+            if(mode == ConnectivityMode::Dynamic){
+                component.resize(id + 1, UINT32_MAX);
+                position.resize(id + 1, 0);
+                links.resize(id + 1);
+            }
+        }
+
+        // lock-step BFS from both ends of a deleted edge; if one side runs out
+        // first it has split off and gets a fresh label
+        void splitIfDisconnected(uint32_t u, uint32_t v){
+            std::vector<uint32_t> side[2] = {{u}, {v}};
+            std::unordered_map<uint32_t, char> seen = {{u, 0}, {v, 1}};
+            std::size_t head[2] = {0, 0};
+            while(head[0] < side[0].size() && head[1] < side[1].size()){
+                for(int s = 0; s < 2; ++s){
+                    uint32_t x = side[s][head[s]++];
+                    for(auto &[y, _] : links[x]){
+                        auto it = seen.find(y);
+                        if(it == seen.end()){
+                            seen.emplace(y, static_cast<char>(s));
+                            side[s].push_back(y);
+                        }
+                        else if(it->second != s){
+                            return; // the two searches met, still connected
+                        }
+                    }
+                }
+            }
+            int smaller = head[0] < side[0].size() ? 1 : 0;
+            uint32_t label = newLabel();
+            for(uint32_t x : side[smaller]){
+                detach(x);
+                attach(x, label);
+            }
+            components++;
+        }
+
+    public:
+        ConnectivityIndex() : mode(ConnectivityMode::None), vertexCount(0), stale(false), components(0) {}
+
+        ConnectivityMode getMode() const { return mode; }
+        bool enabled() const { return mode != ConnectivityMode::None; }
+        // InsertOnly cannot undo a union; the owner rebuilds when this is set
+        bool needsRebuild() const { return stale; }
+
+        void reset(ConnectivityMode newMode){
+            mode = newMode;
+            present.clear();
+            vertexCount = 0;
+            stale = false;
+            dsu.reset(0);
+            component.clear();
+            position.clear();
+            members.clear();
+            freeLabels.clear();
+            links.clear();
+            components = 0;
+        }
+
+        void addVertex(uint32_t id){
+            if(mode == ConnectivityMode::None){
+                return;
+            }
+            grow(id);
+            if(present[id]){
+                return;
+            }
+            present[id] = true;
+            vertexCount++;
+            if(mode == ConnectivityMode::InsertOnly){
+                while(dsu.size() <= id){
+                    dsu.addElement();
+                }
+                if(dsu.componentSize(id) != 1){
+                    stale = true; // recycled id still tied to old unions
+                }
+            }
+            else{
+                attach(id, newLabel());
+                components++;
+            }
+        }
+
+        void addEdge(uint32_t u, uint32_t v){
+            if(mode == ConnectivityMode::None || u == v){
+                return;
+            }
+            addVertex(u);
+            addVertex(v);
+            if(mode == ConnectivityMode::InsertOnly){
+                dsu.unite(u, v);
+                return;
+            }
+            links[u][v]++;
+            links[v][u]++;
+            uint32_t a = component[u], b = component[v];
+            if(a == b){
+                return;
+            }
+            if(members[a].size() < members[b].size()){
+                std::swap(a, b);
+            }
+            for(uint32_t x : members[b]){
+                component[x] = a;
+                position[x] = static_cast<uint32_t>(members[a].size());
+                members[a].push_back(x);
+            }
+            members[b].clear();
+            freeLabels.push_back(b);
+            components--;
+        }
+
+        void removeEdge(uint32_t u, uint32_t v){
+            if(mode == ConnectivityMode::None || u == v){
+                return;
+            }
+            if(mode == ConnectivityMode::InsertOnly){
+                stale = true;
+                return;
+            }
+            auto it = links[u].find(v);
+            if(it == links[u].end()){
+                return;
+            }
+            if(--it->second > 0){
+                links[v][u]--;
+                return;
+            }
+            links[u].erase(it);
+            links[v].erase(u);
+            splitIfDisconnected(u, v);
+        }
+
+        void removeVertex(uint32_t id){
+            if(mode == ConnectivityMode::None || id >= present.size() || !present[id]){
+                return;
+            }
+            if(mode == ConnectivityMode::InsertOnly){
+                stale = true;
+            }
+            else{
+                // peel the edges off one by one, then drop the isolated vertex
+                while(!links[id].empty()){
+                    auto [v, count] = *links[id].begin();
+                    links[id].erase(v);
+                    links[v].erase(id);
+                    splitIfDisconnected(id, v);
+                }
+                detach(id);
+                freeLabels.push_back(component[id]);
+                component[id] = UINT32_MAX;
+                components--;
+            }
+            present[id] = false;
+            vertexCount--;
+        }
+
+        bool connected(uint32_t u, uint32_t v){
+            if(mode == ConnectivityMode::InsertOnly){
+                return dsu.connected(u, v);
+            }
+            return component[u] == component[v];
+        }
+
+        std::size_t componentCount() const{
+            if(mode == ConnectivityMode::InsertOnly){
+                // ids that are not live vertices sit in the union-find as singletons
+                return dsu.componentCount() - (dsu.size() - vertexCount);
+            }
+            return components;
+        }
+};
+
+#endif
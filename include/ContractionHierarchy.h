@@ -0,0 +1,635 @@
+#ifndef ContractionHierarchy_H
+#define ContractionHierarchy_H
+
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <climits>
+#include <cstdint>
+#include "Heap.h"
+#include "CsrGraph.h"
+
+// Contraction hierarchy over a static graph with non-negative weights.
+// Preprocessing contracts the vertices one at a time, cheapest first, and adds
+// a shortcut u->w for every u->v->w that is the only shortest path around the
+// contracted v. Every edge then points upwards (to a later contracted vertex)
+// in either the forward or the backward search graph, and a query is a
+// bidirectional Dijkstra that only ever climbs, touching a few hundred
+// vertices instead of the whole graph.
+//
+// Queries reuse scratch buffers owned by the hierarchy, so a single instance
+// must not be queried from several threads at once; copy it per thread.
+template <typename T>
+class ContractionHierarchy {
+    private:
+        static constexpr uint32_t none = UINT32_MAX;
+        static constexpr uint32_t magic = 0x58494843; // "CHIX"
+        static constexpr uint32_t formatVersion = 1;
+
+        // an upward edge; middle is the contracted vertex a shortcut skips, none for original edges
+        struct Arc {
+            uint32_t target;
+            int w;
+            uint32_t middle;
+        };
+
+        std::vector<T> vertices;
+        std::unordered_map<T, uint32_t> vertexId;
+        std::vector<uint32_t> rank; // contraction order, higher is more important
+        // upward search graphs in CSR form, each row sorted by target:
+        // up[v] holds v->x, down[v] holds x->v, both with rank[x] > rank[v]
+        std::vector<std::size_t> upOffsets, downOffsets;
+        std::vector<Arc> upArcs, downArcs;
+
+        // query scratch, reset through the touched list after every query
+        std::vector<int> distance[2];
+        std::vector<uint32_t> parent[2];
+        std::vector<uint32_t> touched;
+        LazyBinaryHeap pq[2];
+
+        // preprocessing state
+        struct Edge {
+            int w;
+            uint32_t middle;
+        };
+        typedef std::vector<std::unordered_map<uint32_t, Edge>> Adjacency;
+        struct Builder {
+            Adjacency out, in;
+            std::vector<bool> contracted;
+            std::vector<int> deletedNeighbours, level;
+            std::vector<int> witnessDistance;
+            std::vector<uint32_t> witnessTouched;
+            LazyBinaryHeap witnessQueue;
+        };
+        // witness searches give up after settling this many vertices; a missed
+        // witness only costs a redundant shortcut. Scoring uses a tighter bound.
+        static constexpr std::size_t witnessSettleLimit = 500;
+        static constexpr std::size_t simulateSettleLimit = 50;
+
+        void build(const CsrGraph<T> &graph);
+        void witnessSearch(Builder &b, uint32_t source, uint32_t skip, long long limit, std::size_t settleLimit);
+        int contract(Builder &b, uint32_t v, bool simulate);
+        int priority(Builder &b, uint32_t v);
+        void resetScratch();
+
+        int search(uint32_t s, uint32_t t, uint32_t &meet);
+        const Arc* findArc(uint32_t from, uint32_t to) const;
+        void unpackArc(uint32_t from, uint32_t to, std::vector<uint32_t> &path) const;
+        uint32_t lookup(const T &v) const;
+        bool validate() const;
+
+        static void writeVertex(std::ostream &out, const std::string &v);
+        template <typename U>
+        static void writeVertex(std::ostream &out, const U &v);
+        static void readVertex(std::istream &in, std::string &v);
+        template <typename U>
+        static void readVertex(std::istream &in, U &v);
+
+    public:
+        ContractionHierarchy() : upOffsets(1, 0), downOffsets(1, 0) {}
+        explicit ContractionHierarchy(const CsrGraph<T> &graph);
+
+        std::size_t getVertexCount() const { return vertices.size(); }
+        std::size_t getShortcutCount() const;
+        bool hasVertex(const T &v) const { return vertexId.find(v) != vertexId.end(); }
+
+        // -1 if target is unreachable
+        int getDistance(T source, T target);
+        // {distance, path} with shortcuts unpacked into original edges, {-1, {}} if unreachable
+        std::pair<int, std::vector<T>> getShortestPath(T source, T target);
+
+        // binary format; vertices must be trivially copyable or std::string
+        void save(std::ostream &out) const;
+        static ContractionHierarchy<T> load(std::istream &in);
+};
+
+template <typename T>
+ContractionHierarchy<T>::ContractionHierarchy(const CsrGraph<T> &graph){
+    for(auto &w : graph.getWeights()){
+        if(w < 0){
+            throw std::invalid_argument("Contraction hierarchies require non-negative weights");
+        }
+    }
+    build(graph);
+    resetScratch();
+}
+
+template <typename T>
+void ContractionHierarchy<T>::build(const CsrGraph<T> &graph){
+    uint32_t n = static_cast<uint32_t>(graph.getVertexCount());
+    vertices = graph.getVertices();
+    for(uint32_t i = 0; i < n; ++i){
+        vertexId[vertices[i]] = i;
+    }
+
+    Builder b;
+    b.out.resize(n);
+    b.in.resize(n);
+    b.contracted.assign(n, false);
+    b.deletedNeighbours.assign(n, 0);
+    b.level.assign(n, 0);
+    b.witnessDistance.assign(n, INT_MAX);
+
+    auto &offsets = graph.getOffsets();
+    auto &neighbors = graph.getNeighbors();
+    auto &weights = graph.getWeights();
+    for(uint32_t u = 0; u < n; ++u){
+        for(std::size_t i = offsets[u]; i < offsets[u + 1]; ++i){
+            uint32_t v = neighbors[i];
+            if(u == v){
+                continue;
+            }
+            auto it = b.out[u].find(v);
+            if(it == b.out[u].end() || weights[i] < it->second.w){
+                b.out[u][v] = {weights[i], none};
+                b.in[v][u] = {weights[i], none};
+            }
+        }
+    }
+
+    // lazy updates: a popped vertex is re-scored and put back if it got worse
+    std::vector<int> score(n);
+    LazyBinaryHeap queue(n);
+    for(uint32_t v = 0; v < n; ++v){
+        score[v] = priority(b, v);
+        queue.push(score[v], v);
+    }
+
+    rank.assign(n, 0);
+    std::vector<std::vector<Arc>> up(n), down(n);
+    uint32_t order = 0;
+    while(!queue.empty()){
+        auto [key, v] = queue.pop();
+        if(b.contracted[v] || key != score[v]){
+            continue;
+        }
+        score[v] = priority(b, v);
+        if(!queue.empty() && score[v] > queue.top().first){
+            queue.push(score[v], v);
+            continue;
+        }
+
+        contract(b, v, false);
+        rank[v] = order++;
+        b.contracted[v] = true;
+
+        // whatever is still attached to v gets contracted later, so these are v's upward arcs
+        for(auto &[x, e] : b.out[v]){
+            up[v].push_back({x, e.w, e.middle});
+            b.in[x].erase(v);
+        }
+        for(auto &[x, e] : b.in[v]){
+            down[v].push_back({x, e.w, e.middle});
+            b.out[x].erase(v);
+        }
+
+        std::vector<uint32_t> touchedNeighbours;
+        for(auto &arc : up[v]){
+            touchedNeighbours.push_back(arc.target);
+        }
+        for(auto &arc : down[v]){
+            touchedNeighbours.push_back(arc.target);
+        }
+        b.out[v].clear();
+        b.in[v].clear();
+        std::sort(touchedNeighbours.begin(), touchedNeighbours.end());
+        touchedNeighbours.erase(std::unique(touchedNeighbours.begin(), touchedNeighbours.end()), touchedNeighbours.end());
+        for(uint32_t x : touchedNeighbours){
+            b.deletedNeighbours[x]++;
+            b.level[x] = std::max(b.level[x], b.level[v] + 1);
+            score[x] = priority(b, x);
+            queue.push(score[x], x);
+        }
+    }
+
+    auto flatten = [n](std::vector<std::vector<Arc>> &rows, std::vector<std::size_t> &rowOffsets, std::vector<Arc> &arcs){
+        rowOffsets.assign(n + 1, 0);
+        for(uint32_t v = 0; v < n; ++v){
+            std::sort(rows[v].begin(), rows[v].end(), [](const Arc &a, const Arc &b){ return a.target < b.target; });
+            rowOffsets[v + 1] = rowOffsets[v] + rows[v].size();
+        }
+        arcs.clear();
+        arcs.reserve(rowOffsets[n]);
+        for(uint32_t v = 0; v < n; ++v){
+            arcs.insert(arcs.end(), rows[v].begin(), rows[v].end());
+        }
+    };
+    flatten(up, upOffsets, upArcs);
+    flatten(down, downOffsets, downArcs);
+}
+
+// bounded Dijkstra from source over the remaining graph, never entering skip
+template <typename T>
+void ContractionHierarchy<T>::witnessSearch(Builder &b, uint32_t source, uint32_t skip, long long limit, std::size_t settleLimit){
+    for(uint32_t x : b.witnessTouched){
+        b.witnessDistance[x] = INT_MAX;
+    }
+    b.witnessTouched.clear();
+
+    LazyBinaryHeap &local = b.witnessQueue;
+    local.clear();
+    b.witnessDistance[source] = 0;
+    b.witnessTouched.push_back(source);
+    local.push(0, source);
+    std::size_t settled = 0;
+    while(!local.empty() && settled < settleLimit){
+        auto [dis, u] = local.pop();
+        if(dis > b.witnessDistance[u]){
+            continue;
+        }
+        if(dis > limit){
+            break;
+        }
+        settled++;
+        for(auto &[x, e] : b.out[u]){
+            if(x == skip){
+                continue;
+            }
+            long long candidate = static_cast<long long>(dis) + e.w;
+            if(candidate < b.witnessDistance[x]){
+                if(b.witnessDistance[x] == INT_MAX){
+                    b.witnessTouched.push_back(x);
+                }
+                b.witnessDistance[x] = static_cast<int>(candidate);
+                local.push(b.witnessDistance[x], x);
+            }
+        }
+    }
+}
+
+// returns the number of shortcuts contracting v needs; adds them unless simulating
+template <typename T>
+int ContractionHierarchy<T>::contract(Builder &b, uint32_t v, bool simulate){
+    int shortcuts = 0;
+    std::vector<std::pair<uint32_t, Edge>> incoming(b.in[v].begin(), b.in[v].end());
+    std::vector<std::pair<uint32_t, Edge>> outgoing(b.out[v].begin(), b.out[v].end());
+    for(auto &[u, first] : incoming){
+        long long limit = -1;
+        for(auto &[x, second] : outgoing){
+            if(x != u){
+                limit = std::max(limit, static_cast<long long>(first.w) + second.w);
+            }
+        }
+        if(limit < 0){
+            continue; // v only leads back to u
+        }
+        witnessSearch(b, u, v, limit, simulate ? simulateSettleLimit : witnessSettleLimit);
+        for(auto &[x, second] : outgoing){
+            if(x == u){
+                continue;
+            }
+            long long through = static_cast<long long>(first.w) + second.w;
+            if(b.witnessDistance[x] <= through){
+                continue;
+            }
+            shortcuts++;
+            if(simulate){
+                continue;
+            }
+            int w = static_cast<int>(std::min<long long>(through, INT_MAX - 1));
+            auto it = b.out[u].find(x);
+            if(it == b.out[u].end() || w < it->second.w){
+                b.out[u][x] = {w, v};
+                b.in[x][u] = {w, v};
+            }
+        }
+    }
+    return shortcuts;
+}
+
+// edge difference + contracted neighbours + depth, the usual cheap ordering heuristic
+template <typename T>
+int ContractionHierarchy<T>::priority(Builder &b, uint32_t v){
+    int removed = static_cast<int>(b.in[v].size() + b.out[v].size());
+    int shortcuts = contract(b, v, true);
+    return 2 * (shortcuts - removed) + b.deletedNeighbours[v] + b.level[v];
+}
+
+template <typename T>
+void ContractionHierarchy<T>::resetScratch(){
+    std::size_t n = vertices.size();
+    for(int side = 0; side < 2; ++side){
+        distance[side].assign(n, INT_MAX);
+        parent[side].assign(n, none);
+        pq[side].clear();
+    }
+    touched.clear();
+}
+
+template <typename T>
+std::size_t ContractionHierarchy<T>::getShortcutCount() const{
+    std::size_t count = 0;
+    for(auto &arc : upArcs){
+        count += arc.middle != none;
+    }
+    for(auto &arc : downArcs){
+        count += arc.middle != none;
+    }
+    return count;
+}
+
+template <typename T>
+uint32_t ContractionHierarchy<T>::lookup(const T &v) const{
+    auto it = vertexId.find(v);
+    if(it == vertexId.end()){
+        throw std::invalid_argument("Vertex not found");
+    }
+    return it->second;
+}
+
+// Upward Dijkstra from s (up arcs) and t (down arcs), always advancing the
+// smaller queue head. Returns the distance (-1 if none) and leaves the two
+// parent trees in the scratch buffers for unpacking. A settled vertex that is
+// reached more cheaply from above (stall-on-demand) cannot be on a shortest
+// up-down path, so its arcs are not relaxed.
+template <typename T>
+int ContractionHierarchy<T>::search(uint32_t s, uint32_t t, uint32_t &meet){
+    for(uint32_t x : touched){
+        distance[0][x] = distance[1][x] = INT_MAX;
+        parent[0][x] = parent[1][x] = none;
+    }
+    touched.clear();
+    pq[0].clear();
+    pq[1].clear();
+
+    distance[0][s] = 0;
+    distance[1][t] = 0;
+    touched.push_back(s);
+    touched.push_back(t);
+    pq[0].push(0, s);
+    pq[1].push(0, t);
+
+    const std::vector<std::size_t> *rowOffsets[2] = {&upOffsets, &downOffsets};
+    const std::vector<Arc> *arcs[2] = {&upArcs, &downArcs};
+    long long best = LLONG_MAX;
+    meet = none;
+    while(!pq[0].empty() || !pq[1].empty()){
+        int side = pq[1].empty() || (!pq[0].empty() && pq[0].top().first <= pq[1].top().first) ? 0 : 1;
+        if(pq[side].top().first >= best){
+            break;
+        }
+        auto [dis, u] = pq[side].pop();
+        if(dis > distance[side][u]){
+            continue;
+        }
+        if(distance[1 - side][u] != INT_MAX && static_cast<long long>(dis) + distance[1 - side][u] < best){
+            best = static_cast<long long>(dis) + distance[1 - side][u];
+            meet = u;
+        }
+        bool stalled = false;
+        for(std::size_t i = (*rowOffsets[1 - side])[u]; i < (*rowOffsets[1 - side])[u + 1] && !stalled; ++i){
+            const Arc &arc = (*arcs[1 - side])[i];
+            stalled = distance[side][arc.target] != INT_MAX && static_cast<long long>(distance[side][arc.target]) + arc.w < dis;
+        }
+        if(stalled){
+            continue;
+        }
+        for(std::size_t i = (*rowOffsets[side])[u]; i < (*rowOffsets[side])[u + 1]; ++i){
+            const Arc &arc = (*arcs[side])[i];
+            long long candidate = static_cast<long long>(dis) + arc.w;
+            if(candidate < distance[side][arc.target]){
+                if(distance[0][arc.target] == INT_MAX && distance[1][arc.target] == INT_MAX){
+                    touched.push_back(arc.target);
+                }
+                distance[side][arc.target] = static_cast<int>(candidate);
+                parent[side][arc.target] = u;
+                pq[side].push(distance[side][arc.target], arc.target);
+            }
+        }
+    }
+    return best == LLONG_MAX ? -1 : static_cast<int>(best);
+}
+
+// the stored arc from->to: it lives with whichever endpoint was contracted first
+template <typename T>
+const typename ContractionHierarchy<T>::Arc* ContractionHierarchy<T>::findArc(uint32_t from, uint32_t to) const{
+    bool upward = rank[from] < rank[to];
+    uint32_t row = upward ? from : to, target = upward ? to : from;
+    const std::vector<std::size_t> &rowOffsets = upward ? upOffsets : downOffsets;
+    const std::vector<Arc> &arcs = upward ? upArcs : downArcs;
+    auto first = arcs.begin() + rowOffsets[row], last = arcs.begin() + rowOffsets[row + 1];
+    auto it = std::lower_bound(first, last, target, [](const Arc &a, uint32_t x){ return a.target < x; });
+    return it != last && it->target == target ? &*it : nullptr;
+}
+
+// appends the original vertices strictly after `from` up to and including `to`
+template <typename T>
+void ContractionHierarchy<T>::unpackArc(uint32_t from, uint32_t to, std::vector<uint32_t> &path) const{
+    std::vector<std::pair<uint32_t, uint32_t>> stack = {{from, to}};
+    while(!stack.empty()){
+        auto [a, c] = stack.back();
+        stack.pop_back();
+        const Arc *arc = findArc(a, c);
+        if(arc->middle == none){
+            path.push_back(c);
+            continue;
+        }
+        stack.push_back({arc->middle, c});
+        stack.push_back({a, arc->middle});
+    }
+}
+
+template <typename T>
+int ContractionHierarchy<T>::getDistance(T source, T target){
+    uint32_t s = lookup(source), t = lookup(target), meet;
+    return search(s, t, meet);
+}
+
+template <typename T>
+std::pair<int, std::vector<T>> ContractionHierarchy<T>::getShortestPath(T source, T target){
+    uint32_t s = lookup(source), t = lookup(target), meet;
+    int dist = search(s, t, meet);
+    if(dist == -1){
+        return {-1, {}};
+    }
+
+    std::vector<uint32_t> hops; // s .. meet .. t in the search graphs
+    for(uint32_t x = meet; x != none; x = parent[0][x]){
+        hops.push_back(x);
+    }
+    std::reverse(hops.begin(), hops.end());
+    for(uint32_t x = parent[1][meet]; x != none; x = parent[1][x]){
+        hops.push_back(x);
+    }
+
+    std::vector<uint32_t> path = {s};
+    for(std::size_t i = 0; i + 1 < hops.size(); ++i){
+        unpackArc(hops[i], hops[i + 1], path);
+    }
+    std::vector<T> result;
+    result.reserve(path.size());
+    for(uint32_t id : path){
+        result.push_back(vertices[id]);
+    }
+    return {dist, result};
+}
+
+template <typename T>
+void ContractionHierarchy<T>::writeVertex(std::ostream &out, const std::string &v){
+    uint64_t length = v.size();
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.write(v.data(), static_cast<std::streamsize>(length));
+}
+
+template <typename T>
+template <typename U>
+void ContractionHierarchy<T>::writeVertex(std::ostream &out, const U &v){
+    static_assert(std::is_trivially_copyable<U>::value, "vertex type must be trivially copyable or std::string");
+    out.write(reinterpret_cast<const char*>(&v), sizeof(U));
+}
+
+template <typename T>
+void ContractionHierarchy<T>::readVertex(std::istream &in, std::string &v){
+    uint64_t length = 0;
+    in.read(reinterpret_cast<char*>(&length), sizeof(length));
+    // read in pieces, like the arrays in load()
+    const uint64_t chunk = 1 << 16;
+    v.clear();
+    for(uint64_t done = 0; done < length && in; done += chunk){
+        std::size_t count = static_cast<std::size_t>(std::min(chunk, length - done));
+        v.resize(static_cast<std::size_t>(done) + count);
+        in.read(&v[static_cast<std::size_t>(done)], static_cast<std::streamsize>(count));
+    }
+}
+
+template <typename T>
+template <typename U>
+void ContractionHierarchy<T>::readVertex(std::istream &in, U &v){
+    static_assert(std::is_trivially_copyable<U>::value, "vertex type must be trivially copyable or std::string");
+    in.read(reinterpret_cast<char*>(&v), sizeof(U));
+}
+
+// Everything a query or path unpacking relies on: rank is a permutation,
+// both halves are well-formed CSR with rows sorted by target and arcs that
+// point strictly upwards with non-negative weights, and every shortcut's two
+// halves exist one level down.
+template <typename T>
+bool ContractionHierarchy<T>::validate() const{
+    const std::size_t n = vertices.size();
+    if(rank.size() != n || upOffsets.size() != n + 1 || downOffsets.size() != n + 1){
+        return false;
+    }
+    std::vector<char> seen(n, 0);
+    for(uint32_t r : rank){
+        if(r >= n || seen[r]){
+            return false;
+        }
+        seen[r] = 1;
+    }
+    for(int side = 0; side < 2; ++side){
+        const std::vector<std::size_t> &rowOffsets = side == 0 ? upOffsets : downOffsets;
+        const std::vector<Arc> &arcs = side == 0 ? upArcs : downArcs;
+        if(rowOffsets[0] != 0 || rowOffsets[n] != arcs.size()){
+            return false;
+        }
+        for(std::size_t v = 0; v < n; ++v){
+            if(rowOffsets[v] > rowOffsets[v + 1]){
+                return false;
+            }
+        }
+        for(std::size_t v = 0; v < n; ++v){
+            for(std::size_t i = rowOffsets[v]; i < rowOffsets[v + 1]; ++i){
+                const Arc &arc = arcs[i];
+                if(arc.target >= n || rank[arc.target] <= rank[v] || arc.w < 0){
+                    return false;
+                }
+                if(i > rowOffsets[v] && arcs[i - 1].target >= arc.target){
+                    return false; // findArc binary searches the row
+                }
+            }
+        }
+    }
+    // checked after the loop above, findArc needs every row in bounds
+    for(int side = 0; side < 2; ++side){
+        const std::vector<std::size_t> &rowOffsets = side == 0 ? upOffsets : downOffsets;
+        const std::vector<Arc> &arcs = side == 0 ? upArcs : downArcs;
+        for(uint32_t v = 0; v < n; ++v){
+            for(std::size_t i = rowOffsets[v]; i < rowOffsets[v + 1]; ++i){
+                const Arc &arc = arcs[i];
+                if(arc.middle == none){
+                    continue;
+                }
+                uint32_t from = side == 0 ? v : arc.target, to = side == 0 ? arc.target : v;
+                if(arc.middle >= n || rank[arc.middle] >= rank[v]
+                   || findArc(from, arc.middle) == nullptr || findArc(arc.middle, to) == nullptr){
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// header, vertex table, ranks, then both CSR halves as raw arrays in native byte order
+template <typename T>
+void ContractionHierarchy<T>::save(std::ostream &out) const{
+    auto writeArray = [&out](const auto &array){
+        uint64_t size = array.size();
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write(reinterpret_cast<const char*>(array.data()), static_cast<std::streamsize>(size * sizeof(array[0])));
+    };
+    out.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+    out.write(reinterpret_cast<const char*>(&formatVersion), sizeof(formatVersion));
+    uint64_t n = vertices.size();
+    out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    for(auto &v : vertices){
+        writeVertex(out, v);
+    }
+    writeArray(rank);
+    writeArray(upOffsets);
+    writeArray(upArcs);
+    writeArray(downOffsets);
+    writeArray(downArcs);
+    if(!out){
+        throw std::runtime_error("Failed to write contraction hierarchy");
+    }
+}
+
+template <typename T>
+ContractionHierarchy<T> ContractionHierarchy<T>::load(std::istream &in){
+    auto readArray = [&in](auto &array){
+        uint64_t size = 0;
+        in.read(reinterpret_cast<char*>(&size), sizeof(size));
+        // grow with the data actually read, so a corrupt size fails at the end
+        // of the stream instead of allocating whatever it claims
+        const uint64_t chunk = 1 << 16;
+        array.clear();
+        for(uint64_t done = 0; done < size && in; done += chunk){
+            std::size_t count = static_cast<std::size_t>(std::min(chunk, size - done));
+            array.resize(static_cast<std::size_t>(done) + count);
+            in.read(reinterpret_cast<char*>(array.data() + done), static_cast<std::streamsize>(count * sizeof(array[0])));
+        }
+    };
+    uint32_t header[2] = {0, 0};
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if(!in || header[0] != magic || header[1] != formatVersion){
+        throw std::runtime_error("Not a contraction hierarchy file");
+    }
+
+    ContractionHierarchy<T> ch;
+    uint64_t n = 0;
+    in.read(reinterpret_cast<char*>(&n), sizeof(n));
+    for(uint64_t i = 0; i < n && in; ++i){
+        T v{};
+        readVertex(in, v);
+        ch.vertexId[v] = static_cast<uint32_t>(ch.vertices.size());
+        ch.vertices.push_back(v);
+    }
+    readArray(ch.rank);
+    readArray(ch.upOffsets);
+    readArray(ch.upArcs);
+    readArray(ch.downOffsets);
+    readArray(ch.downArcs);
+    if(!in || n != ch.vertices.size() || !ch.validate()){
+        throw std::runtime_error("Corrupt contraction hierarchy file");
+    }
+    ch.resetScratch();
+    return ch;
+}
+
+#endif
@@ -0,0 +1,1846 @@
+#ifndef CsrGraph_H
+#define CsrGraph_H
+
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <queue>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <climits>
+#include <cstdint>
+#include <atomic>
+#include "Heap.h"
+#include "DisjointSet.h"
+#include "Parallel.h"
+
+// Engine selection for getSinglePointShortestPath. Delta-stepping is the
+// multi-threaded engine for non-negative weights; otherwise `heap` picks the
+// Dijkstra queue.
+struct ShortestPathOptions {
+    HeapType heap = HeapType::LazyBinary;
+    bool deltaStepping = false;
+    int delta = 0;        // bucket width, 0 derives one from the weights
+    unsigned threads = 0; // 0 uses every hardware thread
+};
+
+// All-pairs engines: cache-blocked Floyd-Warshall for small or dense graphs,
+// Johnson's (reweighting + one Dijkstra per source, in parallel) for sparse ones.
+enum class APSPAlgorithm { Auto, FloydWarshall, Johnson };
+
+// Minimum spanning tree (forest) engines for undirected graphs.
+enum class MSTAlgorithm { Kruskal, Prim, Boruvka };
+
+// Strongly connected component engines: iterative Tarjan, or a multi-threaded
+// trim + forward-backward + coloring decomposition for large directed graphs.
+enum class SCCAlgorithm { Tarjan, ForwardBackward };
+
+// Vertex orderings for locality. ReverseCuthillMcKee keeps neighbours' ids
+// close (low bandwidth), DegreeDescending packs the hubs together, BFS lays
+// components out level by level from their highest-degree vertex. Directed
+// graphs are ordered by their undirected structure.
+enum class ReorderStrategy { ReverseCuthillMcKee, DegreeDescending, BFS };
+
+// order[newId] = oldId and rank[oldId] = newId between two snapshots of the
+// same graph; restore() turns a per-vertex result of the reordered snapshot
+// back into the original id order.
+struct VertexOrdering {
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> rank;
+
+    template <typename Value>
+    std::vector<Value> restore(const std::vector<Value> &byNewId) const{
+        std::vector<Value> byOldId(byNewId.size());
+        for(std::size_t v = 0; v < byNewId.size(); ++v){
+            byOldId[order[v]] = byNewId[v];
+        }
+        return byOldId;
+    }
+};
+
+struct StronglyConnectedComponents;
+
+// Read-only compressed sparse row snapshot of a graph.
+// Vertices are mapped to dense ids 0..V-1 and the out-edges of vertex i are
+// neighbors[offsets[i] .. offsets[i+1]) with the matching entries in weights.
+// Undirected graphs store every edge in both directions. Directed graphs also
+// keep the reverse (in-edge) arrays for bottom-up and backward traversals.
+template <typename T>
+class CsrGraph {
+    private:
+        std::vector<T> vertices;
+        std::unordered_map<T, uint32_t> vertexId;
+        std::vector<std::size_t> offsets;
+        std::vector<uint32_t> neighbors;
+        std::vector<int> weights;
+        std::vector<std::size_t> inOffsets;
+        std::vector<uint32_t> inNeighbors;
+        bool isDirected;
+        bool isWeighted;
+        bool isNegativelyWeighted;
+
+        uint32_t internVertex(const T& v);
+        void buildReverseIndex();
+        void sortNeighbors();
+
+        bool detectCycleUndirectedDFS() const;
+        bool detectCycleDirectedDFS() const;
+        std::vector<uint32_t> topoOrderDFS() const;
+
+        void getDistanceBFS(uint32_t start, std::vector<int> &distance) const;
+        void getDistanceTopo(uint32_t start, std::vector<int> &distance) const;
+        void getDistanceDijkstra(uint32_t start, std::vector<int> &distance, HeapType heap) const;
+        template <typename Heap>
+        void runDijkstra(uint32_t start, std::vector<int> &distance, Heap &pq) const;
+        void getDistanceBellmanFord(uint32_t start, std::vector<int> &distance) const;
+        void getDistanceDeltaStepping(uint32_t start, std::vector<int> &distance, int delta, unsigned threads) const;
+
+        void getAllDistancesFloydWarshall(std::vector<int> &matrix, unsigned threads) const;
+        void getAllDistancesJohnson(std::vector<int> &matrix, unsigned threads) const;
+        bool getJohnsonPotentials(std::vector<int> &potential) const;
+
+        struct WeightedEdge {
+            int w;
+            uint32_t u, v;
+        };
+        std::vector<WeightedEdge> getUndirectedEdges() const;
+        void getMSTKruskal(std::vector<WeightedEdge> &tree, unsigned threads) const;
+        void getMSTPrim(std::vector<WeightedEdge> &tree) const;
+        void getMSTBoruvka(std::vector<WeightedEdge> &tree, unsigned threads) const;
+
+        std::size_t getSCCTarjan(std::vector<uint32_t> &component, std::size_t count) const;
+        std::size_t getSCCForwardBackward(std::vector<uint32_t> &component, unsigned threads) const;
+        StronglyConnectedComponents buildCondensation(const std::vector<uint32_t> &component, std::size_t count, unsigned threads) const;
+
+        template <std::size_t Words>
+        void runMultiSourceBFS(const std::vector<uint32_t> &sources, std::size_t begin, std::size_t end,
+                               std::vector<std::vector<int>> &distance, std::vector<uint64_t> &scratch) const;
+
+        std::vector<std::pair<T, int>> toDistanceVector(const std::vector<int> &distance) const;
+
+    public:
+        CsrGraph() : offsets(1, 0), isDirected(false), isWeighted(false), isNegativelyWeighted(false) {}
+        // edges are directed arcs in the format returned by Graph<T>::getEdges()
+        CsrGraph(const std::vector<T>& vertexList, const std::vector<std::pair<T, std::pair<T, int>>>& edges, bool isDirected, bool isWeighted);
+
+        std::size_t getVertexCount() const { return vertices.size(); }
+        std::size_t getEdgeCount() const { return neighbors.size(); } // number of stored arcs
+        bool directed() const { return isDirected; }
+        bool weighted() const { return isWeighted; }
+        bool hasVertex(const T& v) const { return vertexId.find(v) != vertexId.end(); }
+        uint32_t getId(const T& v) const;
+        const T& getVertex(uint32_t id) const { return vertices[id]; }
+        const std::vector<T>& getVertices() const { return vertices; }
+        const std::vector<std::size_t>& getOffsets() const { return offsets; }
+        const std::vector<uint32_t>& getNeighbors() const { return neighbors; }
+        const std::vector<int>& getWeights() const { return weights; }
+        std::size_t getDegree(uint32_t id) const { return offsets[id + 1] - offsets[id]; }
+        // in-edges, the same arrays as the out-edges for undirected graphs
+        const std::vector<std::size_t>& getInOffsets() const { return isDirected ? inOffsets : offsets; }
+        const std::vector<uint32_t>& getInNeighbors() const { return isDirected ? inNeighbors : neighbors; }
+
+        std::vector<T> getBFS(T start) const;
+        std::vector<T> getDFS(T start) const;
+        bool hasCycle() const;
+        std::vector<T> getTopologicalOrderDFS() const;
+        std::vector<T> getTopologicalOrderBFS() const;
+        std::vector<std::pair<T, int>> getSinglePointShortestPath(T start, HeapType heap = HeapType::LazyBinary) const;
+        std::vector<std::pair<T, int>> getSinglePointShortestPath(T start, const ShortestPathOptions &options) const;
+        // multi-threaded direction-optimizing BFS, returns the hop distance of every vertex (-1 if unreachable)
+        std::vector<std::pair<T, int>> getParallelBFS(T start, unsigned threads = 0) const;
+        // hop distances from many sources at once, one row per source indexed
+        // by vertex id (-1 if unreachable); see runMultiSourceBFS
+        std::vector<std::vector<int>> getMultiSourceBFS(const std::vector<T> &sources, unsigned threads = 0) const;
+        // distance matrix indexed by vertex id, -1 where unreachable
+        std::vector<std::vector<int>> getAllShortestPath(APSPAlgorithm algorithm = APSPAlgorithm::Auto, unsigned threads = 0) const;
+        // spanning forest edges as {u, {v, w}}, one entry per tree edge
+        std::vector<std::pair<T, std::pair<T, int>>> getMST(MSTAlgorithm algorithm = MSTAlgorithm::Kruskal, unsigned threads = 0) const;
+        StronglyConnectedComponents getStronglyConnectedComponents(SCCAlgorithm algorithm = SCCAlgorithm::Tarjan, unsigned threads = 0) const;
+
+        VertexOrdering getVertexOrdering(ReorderStrategy strategy) const;
+        // the same graph with vertex ordering.order[i] renumbered to i
+        CsrGraph<T> reorder(const VertexOrdering &ordering) const;
+};
+
+// component[id] for every vertex id of the snapshot. Components are numbered
+// in topological order of the condensation, so every arc between two of them
+// goes from a lower to a higher id. The condensation keeps the lightest arc
+// between each pair of components.
+struct StronglyConnectedComponents {
+    std::vector<uint32_t> component;
+    std::size_t count = 0;
+    CsrGraph<uint32_t> condensation;
+};
+
+template <typename T>
+CsrGraph<T>::CsrGraph(const std::vector<T>& vertexList, const std::vector<std::pair<T, std::pair<T, int>>>& edges, bool isDirected, bool isWeighted)
+    : isDirected(isDirected), isWeighted(isWeighted), isNegativelyWeighted(false) {
+    for(auto &v : vertexList){
+        internVertex(v);
+    }
+
+    // resolve every arc once, then counting sort them by source
+    std::vector<std::pair<uint32_t, uint32_t>> arcs;
+    arcs.reserve(edges.size());
+    for(auto &[u, vw] : edges){
+        arcs.push_back({internVertex(u), internVertex(vw.first)});
+    }
+
+    offsets.assign(vertices.size() + 1, 0);
+    for(auto &[u, v] : arcs){
+        offsets[u + 1]++;
+    }
+    for(std::size_t i = 0; i < vertices.size(); ++i){
+        offsets[i + 1] += offsets[i];
+    }
+
+    neighbors.resize(arcs.size());
+    weights.resize(arcs.size());
+    std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+    for(std::size_t i = 0; i < arcs.size(); ++i){
+        std::size_t pos = cursor[arcs[i].first]++;
+        neighbors[pos] = arcs[i].second;
+        weights[pos] = isWeighted ? edges[i].second.second : 1;
+        if(weights[pos] < 0){
+            isNegativelyWeighted = true;
+        }
+    }
+
+    sortNeighbors();
+    if(isDirected){
+        buildReverseIndex();
+    }
+}
+
+// keep each neighbor list sorted by id so traversals walk memory forwards
+template <typename T>
+void CsrGraph<T>::sortNeighbors(){
+    std::vector<std::pair<uint32_t, int>> scratch;
+    for(std::size_t u = 0; u < vertices.size(); ++u){
+        std::size_t begin = offsets[u], end = offsets[u + 1];
+        scratch.clear();
+        for(std::size_t e = begin; e < end; ++e){
+            scratch.push_back({neighbors[e], weights[e]});
+        }
+        std::sort(scratch.begin(), scratch.end());
+        for(std::size_t e = begin; e < end; ++e){
+            neighbors[e] = scratch[e - begin].first;
+            weights[e] = scratch[e - begin].second;
+        }
+    }
+}
+
+template <typename T>
+void CsrGraph<T>::buildReverseIndex(){
+    std::size_t n = vertices.size();
+    inOffsets.assign(n + 1, 0);
+    for(uint32_t v : neighbors){
+        inOffsets[v + 1]++;
+    }
+    for(std::size_t i = 0; i < n; ++i){
+        inOffsets[i + 1] += inOffsets[i];
+    }
+    // sources are visited in increasing order, so every in-list comes out sorted
+    inNeighbors.resize(neighbors.size());
+    std::vector<std::size_t> cursor(inOffsets.begin(), inOffsets.end() - 1);
+    for(uint32_t u = 0; u < n; ++u){
+        for(std::size_t e = offsets[u]; e < offsets[u + 1]; ++e){
+            inNeighbors[cursor[neighbors[e]]++] = u;
+        }
+    }
+}
+
+template <typename T>
+uint32_t CsrGraph<T>::internVertex(const T& v){
+    auto it = vertexId.find(v);
+    if(it != vertexId.end()){
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(vertices.size());
+    vertexId.emplace(v, id);
+    vertices.push_back(v);
+    return id;
+}
+
+template <typename T>
+uint32_t CsrGraph<T>::getId(const T& v) const{
+    auto it = vertexId.find(v);
+    if(it == vertexId.end()){
+        throw std::invalid_argument("Vertex not found");
+    }
+    return it->second;
+}
+
+template <typename T>
+bool CsrGraph<T>::detectCycleUndirectedDFS() const{
+    std::vector<uint32_t> parent(vertices.size(), UINT32_MAX);
+    std::vector<uint32_t> s;
+    for(uint32_t root = 0; root < vertices.size(); ++root){
+        if(parent[root] != UINT32_MAX){
+            continue;
+        }
+        parent[root] = root;
+        s.push_back(root);
+        while(!s.empty()){
+            uint32_t node = s.back();
+            s.pop_back();
+            bool skippedParent = false;
+            for(std::size_t e = offsets[node]; e < offsets[node + 1]; ++e){
+                uint32_t ngb = neighbors[e];
+                if(parent[ngb] == UINT32_MAX){
+                    parent[ngb] = node;
+                    s.push_back(ngb);
+                }
+                else if(ngb == parent[node] && node != root && !skippedParent){
+                    // the tree edge we came in through, seen once from this side
+                    skippedParent = true;
+                }
+                else{
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+template <typename T>
+bool CsrGraph<T>::detectCycleDirectedDFS() const{
+    // 0 = unvisited, 1 = on the current path, 2 = finished
+    std::vector<char> state(vertices.size(), 0);
+    std::vector<std::pair<uint32_t, std::size_t>> s;
+    for(uint32_t root = 0; root < vertices.size(); ++root){
+        if(state[root] != 0){
+            continue;
+        }
+        state[root] = 1;
+        s.push_back({root, offsets[root]});
+        while(!s.empty()){
+            auto &[node, edge] = s.back();
+            if(edge == offsets[node + 1]){
+                state[node] = 2;
+                s.pop_back();
+                continue;
+            }
+            uint32_t ngb = neighbors[edge++];
+            if(state[ngb] == 1){
+                return true;
+            }
+            if(state[ngb] == 0){
+                state[ngb] = 1;
+                s.push_back({ngb, offsets[ngb]});
+            }
+        }
+    }
+    return false;
+}
+
+template <typename T>
+std::vector<uint32_t> CsrGraph<T>::topoOrderDFS() const{
+    std::vector<char> visited(vertices.size(), 0);
+    std::vector<uint32_t> postOrder;
+    postOrder.reserve(vertices.size());
+    std::vector<std::pair<uint32_t, std::size_t>> s;
+    for(uint32_t root = 0; root < vertices.size(); ++root){
+        if(visited[root]){
+            continue;
+        }
+        visited[root] = 1;
+        s.push_back({root, offsets[root]});
+        while(!s.empty()){
+            auto &[node, edge] = s.back();
+            if(edge == offsets[node + 1]){
+                postOrder.push_back(node);
+                s.pop_back();
+                continue;
+            }
+            uint32_t ngb = neighbors[edge++];
+            if(!visited[ngb]){
+                visited[ngb] = 1;
+                s.push_back({ngb, offsets[ngb]});
+            }
+        }
+    }
+    std::reverse(postOrder.begin(), postOrder.end());
+    return postOrder;
+}
+
+template <typename T>
+void CsrGraph<T>::getDistanceBFS(uint32_t start, std::vector<int> &distance) const{
+    std::vector<uint32_t> q;
+    q.reserve(vertices.size());
+    distance[start] = 0;
+    q.push_back(start);
+    for(std::size_t head = 0; head < q.size(); ++head){
+        uint32_t node = q[head];
+        for(std::size_t e = offsets[node]; e < offsets[node + 1]; ++e){
+            uint32_t ngb = neighbors[e];
+            if(distance[ngb] == INT_MAX){
+                distance[ngb] = distance[node] + 1;
+                q.push_back(ngb);
+            }
+        }
+    }
+}
+
+template <typename T>
+void CsrGraph<T>::getDistanceTopo(uint32_t start, std::vector<int> &distance) const{
+    distance[start] = 0;
+    for(uint32_t node : topoOrderDFS()){
+        if(distance[node] == INT_MAX){
+            continue;
+        }
+        for(std::size_t e = offsets[node]; e < offsets[node + 1]; ++e){
+            if(distance[node] + weights[e] < distance[neighbors[e]]){
+                distance[neighbors[e]] = distance[node] + weights[e];
+            }
+        }
+    }
+}
+
+template <typename T>
+template <typename Heap>
+void CsrGraph<T>::runDijkstra(uint32_t start, std::vector<int> &distance, Heap &pq) const{
+    distance[start] = 0;
+    pq.push(0, start);
+    while(!pq.empty()){
+        auto [dis, node] = pq.pop();
+        if(dis > distance[node]){
+            continue; // stale entry
+        }
+        for(std::size_t e = offsets[node]; e < offsets[node + 1]; ++e){
+            uint32_t ngb = neighbors[e];
+            if(dis + weights[e] < distance[ngb]){
+                distance[ngb] = dis + weights[e];
+                pq.push(distance[ngb], ngb);
+            }
+        }
+    }
+}
+
+template <typename T>
+void CsrGraph<T>::getDistanceDijkstra(uint32_t start, std::vector<int> &distance, HeapType heap) const{
+    switch(heap){
+        case HeapType::IndexedDary: {
+            IndexedDaryHeap<4> pq(vertices.size());
+            runDijkstra(start, distance, pq);
+            break;
+        }
+        case HeapType::Radix: {
+            RadixHeap pq;
+            runDijkstra(start, distance, pq);
+            break;
+        }
+        default: {
+            LazyBinaryHeap pq(vertices.size());
+            runDijkstra(start, distance, pq);
+            break;
+        }
+    }
+}
+
+template <typename T>
+void CsrGraph<T>::getDistanceBellmanFord(uint32_t start, std::vector<int> &distance) const{
+    distance[start] = 0;
+    std::size_t n = vertices.size();
+    for(std::size_t i = 0; i < n; ++i){
+        bool relaxed = false;
+        for(uint32_t u = 0; u < n; ++u){
+            if(distance[u] == INT_MAX){
+                continue;
+            }
+            for(std::size_t e = offsets[u]; e < offsets[u + 1]; ++e){
+                if(distance[u] + weights[e] < distance[neighbors[e]]){
+                    distance[neighbors[e]] = distance[u] + weights[e];
+                    relaxed = true;
+                }
+            }
+        }
+        if(!relaxed){
+            return;
+        }
+    }
+    throw std::runtime_error("Graph has a negative weight cycle");
+}
+
+template <typename T>
+std::vector<std::pair<T, int>> CsrGraph<T>::toDistanceVector(const std::vector<int> &distance) const{
+    std::vector<std::pair<T, int>> disVector;
+    disVector.reserve(vertices.size());
+    for(uint32_t id = 0; id < vertices.size(); ++id){
+        disVector.push_back({vertices[id], distance[id] == INT_MAX ? -1 : distance[id]});
+    }
+    return disVector;
+}
+
+template <typename T>
+std::vector<T> CsrGraph<T>::getBFS(T start) const{
+    uint32_t source = getId(start);
+    std::vector<T> bfs;
+    std::vector<char> visited(vertices.size(), 0);
+    std::vector<uint32_t> q;
+    q.reserve(vertices.size());
+    q.push_back(source);
+    visited[source] = 1;
+    for(std::size_t head = 0; head < q.size(); ++head){
+        uint32_t node = q[head];
+        bfs.push_back(vertices[node]);
+        for(std::size_t e = offsets[node]; e < offsets[node + 1]; ++e){
+            if(!visited[neighbors[e]]){
+                visited[neighbors[e]] = 1;
+                q.push_back(neighbors[e]);
+            }
+        }
+    }
+    return bfs;
+}
+
+template <typename T>
+std::vector<T> CsrGraph<T>::getDFS(T start) const{
+    uint32_t source = getId(start);
+    std::vector<T> dfs;
+    std::vector<char> visited(vertices.size(), 0);
+    std::vector<uint32_t> s;
+    s.push_back(source);
+    visited[source] = 1;
+    while(!s.empty()){
+        uint32_t node = s.back();
+        s.pop_back();
+        dfs.push_back(vertices[node]);
+        for(std::size_t e = offsets[node]; e < offsets[node + 1]; ++e){
+            if(!visited[neighbors[e]]){
+                visited[neighbors[e]] = 1;
+                s.push_back(neighbors[e]);
+            }
+        }
+    }
+    return dfs;
+}
+
+template <typename T>
+bool CsrGraph<T>::hasCycle() const{
+    if(isDirected){
+        return detectCycleDirectedDFS();
+    }
+    return detectCycleUndirectedDFS();
+}
+
+template <typename T>
+std::vector<T> CsrGraph<T>::getTopologicalOrderDFS() const{
+    if(hasCycle()){
+        throw std::runtime_error("Graph has a cycle. Topological sort not possible.");
+    }
+    std::vector<T> topologicalOrder;
+    topologicalOrder.reserve(vertices.size());
+    for(uint32_t id : topoOrderDFS()){
+        topologicalOrder.push_back(vertices[id]);
+    }
+    return topologicalOrder;
+}
+
+template <typename T>
+std::vector<T> CsrGraph<T>::getTopologicalOrderBFS() const{
+    if(hasCycle()){
+        throw std::runtime_error("Graph has a cycle. Topological sort not possible.");
+    }
+    std::vector<int> inDegree(vertices.size(), 0);
+    for(uint32_t v : neighbors){
+        inDegree[v]++;
+    }
+
+    std::vector<uint32_t> q;
+    q.reserve(vertices.size());
+    for(uint32_t id = 0; id < vertices.size(); ++id){
+        if(inDegree[id] == 0){
+            q.push_back(id);
+        }
+    }
+    for(std::size_t head = 0; head < q.size(); ++head){
+        uint32_t node = q[head];
+        for(std::size_t e = offsets[node]; e < offsets[node + 1]; ++e){
+            if(--inDegree[neighbors[e]] == 0){
+                q.push_back(neighbors[e]);
+            }
+        }
+    }
+
+    std::vector<T> topologicalOrder;
+    topologicalOrder.reserve(q.size());
+    for(uint32_t id : q){
+        topologicalOrder.push_back(vertices[id]);
+    }
+    return topologicalOrder;
+}
+
+template <typename T>
+std::vector<std::pair<T, int>> CsrGraph<T>::getSinglePointShortestPath(T start, HeapType heap) const{
+    uint32_t source = getId(start);
+    std::vector<int> distance(vertices.size(), INT_MAX);
+
+    if(!isWeighted){
+        // TC: O(V+E)
+        getDistanceBFS(source, distance);
+    }
+    else if(!isNegativelyWeighted){
+        // TC: O((V+E)logV)
+        getDistanceDijkstra(source, distance, heap);
+    }
+    else if(isDirected && !detectCycleDirectedDFS()){
+        // negative weights on a DAG, relax in topological order TC: O(V+E)
+        getDistanceTopo(source, distance);
+    }
+    else{
+        // TC: O(VE)
+        getDistanceBellmanFord(source, distance);
+    }
+
+    return toDistanceVector(distance);
+}
+
+template <typename T>
+std::vector<std::pair<T, int>> CsrGraph<T>::getSinglePointShortestPath(T start, const ShortestPathOptions &options) const{
+    if(!options.deltaStepping){
+        return getSinglePointShortestPath(start, options.heap);
+    }
+    if(isNegativelyWeighted){
+        throw std::invalid_argument("Delta-stepping requires non-negative weights");
+    }
+    uint32_t source = getId(start);
+    std::vector<int> distance(vertices.size(), INT_MAX);
+    getDistanceDeltaStepping(source, distance, options.delta, options.threads);
+    return toDistanceVector(distance);
+}
+
+// Delta-stepping (Meyer & Sanders). Tentative distances are grouped into
+// buckets of width delta; the lowest bucket is drained in parallel phases
+// that relax light edges (w <= delta) until it stops refilling, then the heavy
+// edges of everything it settled are relaxed once. Distances are lowered with
+// a CAS loop so threads can relax into the same vertex.
+template <typename T>
+void CsrGraph<T>::getDistanceDeltaStepping(uint32_t start, std::vector<int> &distance, int delta, unsigned threads) const{
+    threads = resolveThreadCount(threads);
+    const std::size_t n = vertices.size();
+    const std::size_t grain = 64;
+
+    int maxWeight = 1;
+    for(int w : weights){
+        maxWeight = std::max(maxWeight, w);
+    }
+    if(delta <= 0){
+        std::size_t avgDegree = n == 0 ? 1 : std::max<std::size_t>(1, neighbors.size() / n);
+        delta = std::max(1, static_cast<int>(maxWeight / avgDegree));
+    }
+    // pending distances always lie within maxWeight of the current bucket, so a
+    // ring of maxWeight / delta + 2 buckets is enough; cap it at about a million
+    const int maxBuckets = 1 << 20;
+    delta = std::max(delta, maxWeight / maxBuckets + 1);
+    const std::size_t ringSize = static_cast<std::size_t>(maxWeight / delta) + 2;
+
+    std::vector<std::atomic<int>> dist(n);
+    for(auto &d : dist){
+        d.store(INT_MAX, std::memory_order_relaxed);
+    }
+    std::vector<std::vector<uint32_t>> buckets(ringSize);
+    std::vector<std::vector<uint32_t>> buffers(threads);
+    // distance a vertex last had its light / heavy edges relaxed at, to drop duplicates
+    std::vector<int> lightDone(n, -1), heavyDone(n, -1);
+    std::size_t queued = 1;
+
+    dist[start].store(0, std::memory_order_relaxed);
+    buckets[0].push_back(start);
+
+    auto relax = [&](const std::vector<uint32_t> &frontier, bool light){
+        parallelFor(0, frontier.size(), threads, grain, [&](std::size_t lo, std::size_t hi, unsigned tid){
+            std::vector<uint32_t> &out = buffers[tid];
+            for(std::size_t i = lo; i < hi; ++i){
+                uint32_t u = frontier[i];
+                int du = dist[u].load(std::memory_order_relaxed);
+                for(std::size_t e = offsets[u]; e < offsets[u + 1]; ++e){
+                    if((weights[e] <= delta) != light){
+                        continue;
+                    }
+                    int nd = du + weights[e];
+                    uint32_t v = neighbors[e];
+                    int old = dist[v].load(std::memory_order_relaxed);
+                    while(nd < old){
+                        if(dist[v].compare_exchange_weak(old, nd, std::memory_order_relaxed)){
+                            out.push_back(v);
+                            break;
+                        }
+                    }
+                }
+            }
+        });
+        for(auto &out : buffers){
+            for(uint32_t v : out){
+                buckets[(dist[v].load(std::memory_order_relaxed) / delta) % ringSize].push_back(v);
+            }
+            queued += out.size();
+            out.clear();
+        }
+    };
+
+    std::vector<uint32_t> frontier, settled;
+    for(std::size_t current = 0; queued > 0; ++current){
+        std::vector<uint32_t> &bucket = buckets[current % ringSize];
+        if(bucket.empty()){
+            continue;
+        }
+        settled.clear();
+        while(!bucket.empty()){
+            queued -= bucket.size();
+            frontier.clear();
+            for(uint32_t u : bucket){
+                int du = dist[u].load(std::memory_order_relaxed);
+                if(static_cast<std::size_t>(du / delta) != current){
+                    continue; // already moved to a lower bucket and handled there
+                }
+                if(lightDone[u] != du){
+                    lightDone[u] = du;
+                    frontier.push_back(u);
+                    settled.push_back(u);
+                }
+            }
+            bucket.clear();
+            relax(frontier, true);
+        }
+
+        frontier.clear();
+        for(uint32_t u : settled){
+            int du = dist[u].load(std::memory_order_relaxed);
+            if(heavyDone[u] != du){
+                heavyDone[u] = du;
+                frontier.push_back(u);
+            }
+        }
+        relax(frontier, false);
+    }
+
+    for(std::size_t i = 0; i < n; ++i){
+        distance[i] = dist[i].load(std::memory_order_relaxed);
+    }
+}
+
+// Level-synchronous BFS (Beamer et al.): each level is expanded in parallel,
+// top-down from the frontier while it is small, and bottom-up (every unvisited
+// vertex looks for a parent in the frontier) once the frontier's edges
+// outnumber a fraction of the unexplored edges.
+template <typename T>
+std::vector<std::pair<T, int>> CsrGraph<T>::getParallelBFS(T start, unsigned threads) const{
+    uint32_t source = getId(start);
+    threads = resolveThreadCount(threads);
+    const std::size_t n = vertices.size();
+    const std::size_t words = (n + 63) / 64;
+    const std::vector<std::size_t> &inOff = getInOffsets();
+    const std::vector<uint32_t> &inNgb = getInNeighbors();
+    const std::size_t alpha = 15, beta = 18;
+    const std::size_t grain = 256;
+
+    std::vector<int> distance(n, INT_MAX);
+    std::vector<std::atomic<uint64_t>> visited(words);
+    for(auto &w : visited){
+        w.store(0, std::memory_order_relaxed);
+    }
+    std::vector<uint64_t> frontierBits(words, 0), nextBits(words, 0);
+    std::vector<uint32_t> frontier{source};
+    std::vector<std::vector<uint32_t>> buffers(threads);
+    std::vector<std::size_t> scoutCounts(threads);
+
+    distance[source] = 0;
+    visited[source >> 6].store(uint64_t(1) << (source & 63), std::memory_order_relaxed);
+    std::size_t frontierEdges = getDegree(source);
+    std::size_t unexploredEdges = neighbors.size() - frontierEdges;
+    bool bottomUp = false;
+    std::size_t frontierSize = 1;
+
+    for(int level = 0; frontierSize > 0; ++level){
+        if(!bottomUp && frontierEdges > unexploredEdges / alpha){
+            bottomUp = true;
+            std::fill(frontierBits.begin(), frontierBits.end(), 0);
+            for(uint32_t u : frontier){
+                frontierBits[u >> 6] |= uint64_t(1) << (u & 63);
+            }
+        }
+        else if(bottomUp && frontierSize < n / beta){
+            bottomUp = false;
+            frontier.clear();
+            for(std::size_t w = 0; w < words; ++w){
+                for(uint64_t bits = frontierBits[w]; bits; bits &= bits - 1){
+                    frontier.push_back(static_cast<uint32_t>(w * 64 + __builtin_ctzll(bits)));
+                }
+            }
+        }
+
+        std::fill(scoutCounts.begin(), scoutCounts.end(), 0);
+        if(!bottomUp){
+            parallelFor(0, frontier.size(), threads, grain, [&](std::size_t lo, std::size_t hi, unsigned tid){
+                std::vector<uint32_t> &out = buffers[tid];
+                for(std::size_t i = lo; i < hi; ++i){
+                    uint32_t u = frontier[i];
+                    for(std::size_t e = offsets[u]; e < offsets[u + 1]; ++e){
+                        uint32_t v = neighbors[e];
+                        uint64_t bit = uint64_t(1) << (v & 63);
+                        if(visited[v >> 6].load(std::memory_order_relaxed) & bit){
+                            continue;
+                        }
+                        // only the thread that flips the bit claims v
+                        if(!(visited[v >> 6].fetch_or(bit, std::memory_order_relaxed) & bit)){
+                            distance[v] = level + 1;
+                            out.push_back(v);
+                            scoutCounts[tid] += getDegree(v);
+                        }
+                    }
+                }
+            });
+            frontier.clear();
+            for(auto &out : buffers){
+                frontier.insert(frontier.end(), out.begin(), out.end());
+                out.clear();
+            }
+            frontierSize = frontier.size();
+        }
+        else{
+            // threads own whole 64-vertex words, so the bitmaps need no atomics here
+            std::vector<std::size_t> found(threads, 0);
+            parallelFor(0, words, threads, grain / 64 + 1, [&](std::size_t lo, std::size_t hi, unsigned tid){
+                for(std::size_t w = lo; w < hi; ++w){
+                    uint64_t seen = visited[w].load(std::memory_order_relaxed);
+                    uint64_t fresh = 0;
+                    std::size_t end = std::min(n, (w + 1) * 64);
+                    for(std::size_t v = w * 64; v < end; ++v){
+                        if(seen & (uint64_t(1) << (v & 63))){
+                            continue;
+                        }
+                        for(std::size_t e = inOff[v]; e < inOff[v + 1]; ++e){
+                            uint32_t u = inNgb[e];
+                            if(frontierBits[u >> 6] & (uint64_t(1) << (u & 63))){
+                                distance[v] = level + 1;
+                                fresh |= uint64_t(1) << (v & 63);
+                                scoutCounts[tid] += getDegree(static_cast<uint32_t>(v));
+                                found[tid]++;
+                                break;
+                            }
+                        }
+                    }
+                    nextBits[w] = fresh;
+                    visited[w].store(seen | fresh, std::memory_order_relaxed);
+                }
+            });
+            frontierBits.swap(nextBits);
+            frontierSize = 0;
+            for(std::size_t f : found){
+                frontierSize += f;
+            }
+        }
+
+        frontierEdges = 0;
+        for(std::size_t c : scoutCounts){
+            frontierEdges += c;
+        }
+        unexploredEdges -= std::min(unexploredEdges, frontierEdges);
+    }
+
+    return toDistanceVector(distance);
+}
+
+// MS-BFS (Then et al.): sources[begin, end) share one traversal. Every vertex
+// carries Words*64 bit sets (seen, next and frontier), bit i standing for the
+// i-th source of the batch, so one pass over an edge advances every search
+// that has that edge on its frontier. seen and next sit side by side so an
+// edge touches one cache line of its target. Sparse levels expand a list of
+// frontier vertices, dense ones sweep all vertices in id order.
+template <typename T>
+template <std::size_t Words>
+void CsrGraph<T>::runMultiSourceBFS(const std::vector<uint32_t> &sources, std::size_t begin, std::size_t end,
+                                    std::vector<std::vector<int>> &distance, std::vector<uint64_t> &scratch) const{
+    const std::size_t n = vertices.size();
+    scratch.assign(3 * n * Words, 0);
+    uint64_t *state = scratch.data();           // per vertex: seen words, then next words
+    uint64_t *frontier = state + 2 * n * Words;
+    std::vector<uint32_t> active, upcoming;
+    std::vector<bool> listed(n, false);
+    std::size_t activeEdges = 0;
+
+    for(std::size_t i = begin; i < end; ++i){
+        uint32_t s = sources[i];
+        uint64_t bit = uint64_t(1) << ((i - begin) & 63);
+        state[2 * s * Words + (i - begin) / 64] |= bit;
+        frontier[s * Words + (i - begin) / 64] |= bit;
+        distance[i][s] = 0;
+        if(!listed[s]){
+            listed[s] = true;
+            active.push_back(s);
+            activeEdges += getDegree(s);
+        }
+    }
+    for(uint32_t s : active){
+        listed[s] = false;
+    }
+
+    bool dense = false;
+    auto expand = [&](uint32_t v){
+        const uint64_t *from = frontier + v * Words;
+        for(std::size_t e = offsets[v]; e < offsets[v + 1]; ++e){
+            uint32_t u = neighbors[e];
+            uint64_t *known = state + 2 * u * Words;
+            uint64_t fresh = 0;
+            for(std::size_t w = 0; w < Words; ++w){
+                uint64_t bits = from[w] & ~known[w];
+                known[Words + w] |= bits;
+                fresh |= bits;
+            }
+            if(fresh != 0 && !dense && !listed[u]){
+                listed[u] = true;
+                upcoming.push_back(u);
+            }
+        }
+    };
+
+    for(int level = 1; !active.empty(); ++level){
+        upcoming.clear();
+        dense = activeEdges > neighbors.size() / 16;
+        if(dense){
+            for(uint32_t v = 0; v < n; ++v){
+                uint64_t any = 0;
+                for(std::size_t w = 0; w < Words; ++w){
+                    any |= frontier[v * Words + w];
+                }
+                if(any != 0){
+                    expand(v);
+                }
+            }
+            // collected in id order, which keeps the distance rows' writes sequential
+            for(uint32_t u = 0; u < n; ++u){
+                uint64_t any = 0;
+                for(std::size_t w = 0; w < Words; ++w){
+                    any |= state[2 * u * Words + Words + w];
+                }
+                if(any != 0){
+                    upcoming.push_back(u);
+                }
+            }
+        }
+        else{
+            for(uint32_t v : active){
+                expand(v);
+            }
+        }
+        for(uint32_t v : active){
+            std::fill(frontier + v * Words, frontier + (v + 1) * Words, 0);
+        }
+
+        activeEdges = 0;
+        for(uint32_t u : upcoming){
+            listed[u] = false;
+            uint64_t *known = state + 2 * u * Words;
+            for(std::size_t w = 0; w < Words; ++w){
+                uint64_t bits = known[Words + w];
+                known[Words + w] = 0;
+                known[w] |= bits;
+                frontier[u * Words + w] = bits;
+                for(; bits; bits &= bits - 1){
+                    distance[begin + w * 64 + __builtin_ctzll(bits)][u] = level;
+                }
+            }
+            activeEdges += getDegree(u);
+        }
+        active.swap(upcoming);
+    }
+}
+
+// Batches of 256 sources, or of 64 when that leaves too few batches to keep
+// every thread busy; each thread runs whole batches with its own bit sets.
+template <typename T>
+std::vector<std::vector<int>> CsrGraph<T>::getMultiSourceBFS(const std::vector<T> &sources, unsigned threads) const{
+    std::vector<uint32_t> ids;
+    ids.reserve(sources.size());
+    for(auto &s : sources){
+        ids.push_back(getId(s));
+    }
+    threads = resolveThreadCount(threads);
+    std::vector<std::vector<int>> distance(ids.size(), std::vector<int>(vertices.size(), -1));
+
+    const std::size_t width = (ids.size() + 255) / 256 >= threads ? 256 : 64;
+    const std::size_t batches = (ids.size() + width - 1) / width;
+    std::vector<std::vector<uint64_t>> scratch(threads);
+    parallelFor(0, batches, threads, 1, [&](std::size_t lo, std::size_t hi, unsigned tid){
+        for(std::size_t b = lo; b < hi; ++b){
+            std::size_t begin = b * width, end = std::min(ids.size(), begin + width);
+            if(width == 256){
+                runMultiSourceBFS<4>(ids, begin, end, distance, scratch[tid]);
+            }
+            else{
+                runMultiSourceBFS<1>(ids, begin, end, distance, scratch[tid]);
+            }
+        }
+    });
+    return distance;
+}
+
+template <typename T>
+std::vector<std::vector<int>> CsrGraph<T>::getAllShortestPath(APSPAlgorithm algorithm, unsigned threads) const{
+    const std::size_t n = vertices.size();
+    if(algorithm == APSPAlgorithm::Auto){
+        // V^3 beats V * E log V once the graph is small or dense enough
+        algorithm = (n <= 256 || neighbors.size() * 16 >= n * n) ? APSPAlgorithm::FloydWarshall : APSPAlgorithm::Johnson;
+    }
+
+    std::vector<int> matrix;
+    if(algorithm == APSPAlgorithm::FloydWarshall){
+        getAllDistancesFloydWarshall(matrix, threads);
+    }
+    else{
+        getAllDistancesJohnson(matrix, threads);
+    }
+
+    std::vector<std::vector<int>> distances(n);
+    for(std::size_t i = 0; i < n; ++i){
+        distances[i].assign(matrix.begin() + i * n, matrix.begin() + (i + 1) * n);
+    }
+    return distances;
+}
+
+// Blocked Floyd-Warshall over a padded row-major matrix. For every diagonal
+// block k the k block itself is closed first, then its block row and column,
+// then every other block in parallel; each step is a min-plus update whose
+// inner j loop is a straight vectorizable min over contiguous ints.
+template <typename T>
+void CsrGraph<T>::getAllDistancesFloydWarshall(std::vector<int> &matrix, unsigned threads) const{
+    const std::size_t n = vertices.size();
+    const std::size_t B = 64;
+    const std::size_t N = (n + B - 1) / B * B;
+    const std::size_t blocks = N / B;
+    const int INF = INT_MAX / 2; // INF + INF still fits in an int
+
+    std::vector<int> d(N * N, INF);
+    for(std::size_t i = 0; i < N; ++i){
+        d[i * N + i] = 0;
+    }
+    for(std::size_t u = 0; u < n; ++u){
+        for(std::size_t e = offsets[u]; e < offsets[u + 1]; ++e){
+            int &cell = d[u * N + neighbors[e]];
+            cell = std::min(cell, weights[e]);
+        }
+    }
+
+    // block (ci, cj) = min(itself, block (ci, kb) + block (kb, cj))
+    auto update = [&](std::size_t ci, std::size_t cj, std::size_t kb){
+        for(std::size_t k = kb * B; k < (kb + 1) * B; ++k){
+            const int *rowK = &d[k * N + cj * B];
+            for(std::size_t i = ci * B; i < (ci + 1) * B; ++i){
+                int dik = d[i * N + k];
+                if(dik >= INF){
+                    continue;
+                }
+                int *rowI = &d[i * N + cj * B];
+                for(std::size_t j = 0; j < B; ++j){
+                    rowI[j] = std::min(rowI[j], dik + rowK[j]);
+                }
+            }
+        }
+    };
+
+    for(std::size_t kb = 0; kb < blocks; ++kb){
+        update(kb, kb, kb);
+        parallelFor(0, blocks, threads, 1, [&](std::size_t lo, std::size_t hi, unsigned){
+            for(std::size_t b = lo; b < hi; ++b){
+                if(b != kb){
+                    update(kb, b, kb);
+                    update(b, kb, kb);
+                }
+            }
+        });
+        parallelFor(0, blocks, threads, 1, [&](std::size_t lo, std::size_t hi, unsigned){
+            for(std::size_t ib = lo; ib < hi; ++ib){
+                if(ib == kb){
+                    continue;
+                }
+                for(std::size_t jb = 0; jb < blocks; ++jb){
+                    if(jb != kb){
+                        update(ib, jb, kb);
+                    }
+                }
+            }
+        });
+    }
+
+    matrix.assign(n * n, -1);
+    for(std::size_t i = 0; i < n; ++i){
+        if(d[i * N + i] < 0){
+            throw std::runtime_error("Graph has a negative weight cycle");
+        }
+        for(std::size_t j = 0; j < n; ++j){
+            // unreachable entries can drift below INF through negative edges
+            int dij = d[i * N + j];
+            matrix[i * n + j] = dij >= INF / 2 ? -1 : dij;
+        }
+    }
+}
+
+// Bellman-Ford (SPFA) from a virtual source tied to every vertex with weight 0.
+// Returns false on a negative cycle.
+template <typename T>
+bool CsrGraph<T>::getJohnsonPotentials(std::vector<int> &potential) const{
+    const std::size_t n = vertices.size();
+    potential.assign(n, 0);
+    if(!isNegativelyWeighted){
+        return true;
+    }
+    std::vector<std::size_t> edges(n, 0);
+    std::vector<char> inQueue(n, 1);
+    std::queue<uint32_t> q;
+    for(uint32_t u = 0; u < n; ++u){
+        q.push(u);
+    }
+    while(!q.empty()){
+        uint32_t u = q.front();
+        q.pop();
+        inQueue[u] = 0;
+        for(std::size_t e = offsets[u]; e < offsets[u + 1]; ++e){
+            uint32_t v = neighbors[e];
+            if(potential[u] + weights[e] < potential[v]){
+                potential[v] = potential[u] + weights[e];
+                // hops on v's current path; n or more means it repeats a vertex
+                edges[v] = edges[u] + 1;
+                if(edges[v] >= n){
+                    return false;
+                }
+                if(!inQueue[v]){
+                    inQueue[v] = 1;
+                    q.push(v);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+template <typename T>
+void CsrGraph<T>::getAllDistancesJohnson(std::vector<int> &matrix, unsigned threads) const{
+    const std::size_t n = vertices.size();
+    std::vector<int> h;
+    if(!getJohnsonPotentials(h)){
+        throw std::runtime_error("Graph has a negative weight cycle");
+    }
+
+    matrix.assign(n * n, -1);
+    threads = resolveThreadCount(threads);
+    parallelFor(0, n, threads, 1, [&](std::size_t lo, std::size_t hi, unsigned){
+        std::vector<int> distance(n);
+        LazyBinaryHeap pq(n);
+        for(std::size_t s = lo; s < hi; ++s){
+            std::fill(distance.begin(), distance.end(), INT_MAX);
+            distance[s] = 0;
+            pq.push(0, static_cast<uint32_t>(s));
+            while(!pq.empty()){
+                auto [dis, u] = pq.pop();
+                if(dis > distance[u]){
+                    continue;
+                }
+                for(std::size_t e = offsets[u]; e < offsets[u + 1]; ++e){
+                    uint32_t v = neighbors[e];
+                    // reweighted edges are non-negative
+                    int nd = dis + weights[e] + h[u] - h[v];
+                    if(nd < distance[v]){
+                        distance[v] = nd;
+                        pq.push(nd, v);
+                    }
+                }
+            }
+            int *row = &matrix[s * n];
+            for(std::size_t v = 0; v < n; ++v){
+                if(distance[v] != INT_MAX){
+                    row[v] = distance[v] - h[s] + h[v];
+                }
+            }
+        }
+    });
+}
+
+template <typename T>
+std::vector<std::pair<T, std::pair<T, int>>> CsrGraph<T>::getMST(MSTAlgorithm algorithm, unsigned threads) const{
+    if(isDirected){
+        throw std::runtime_error("Graph is directed. Minimum spanning tree not possible.");
+    }
+
+    std::vector<WeightedEdge> tree;
+    switch(algorithm){
+        case MSTAlgorithm::Prim:
+            getMSTPrim(tree);
+            break;
+        case MSTAlgorithm::Boruvka:
+            getMSTBoruvka(tree, threads);
+            break;
+        default:
+            getMSTKruskal(tree, threads);
+            break;
+    }
+
+    std::vector<std::pair<T, std::pair<T, int>>> mst;
+    mst.reserve(tree.size());
+    for(auto &edge : tree){
+        mst.push_back({vertices[edge.u], {vertices[edge.v], edge.w}});
+    }
+    return mst;
+}
+
+// each undirected edge once (u < v), self loops dropped
+template <typename T>
+std::vector<typename CsrGraph<T>::WeightedEdge> CsrGraph<T>::getUndirectedEdges() const{
+    std::vector<WeightedEdge> edges;
+    edges.reserve(neighbors.size() / 2);
+    for(uint32_t u = 0; u < vertices.size(); ++u){
+        for(std::size_t e = offsets[u]; e < offsets[u + 1]; ++e){
+            if(u < neighbors[e]){
+                edges.push_back({weights[e], u, neighbors[e]});
+            }
+        }
+    }
+    return edges;
+}
+
+template <typename T>
+void CsrGraph<T>::getMSTKruskal(std::vector<WeightedEdge> &tree, unsigned threads) const{
+    std::vector<WeightedEdge> edges = getUndirectedEdges();
+    parallelSort(edges.begin(), edges.end(), threads, [](const WeightedEdge &a, const WeightedEdge &b){
+        return a.w < b.w;
+    });
+
+    DisjointSet dsu(vertices.size());
+    for(auto &edge : edges){
+        if(dsu.unite(edge.u, edge.v)){
+            tree.push_back(edge);
+            if(dsu.componentCount() == 1){
+                break;
+            }
+        }
+    }
+}
+
+template <typename T>
+void CsrGraph<T>::getMSTPrim(std::vector<WeightedEdge> &tree) const{
+    const std::size_t n = vertices.size();
+    std::vector<int> key(n, INT_MAX);
+    std::vector<uint32_t> parent(n, UINT32_MAX);
+    std::vector<char> inTree(n, 0);
+    LazyBinaryHeap pq(n);
+
+    for(uint32_t root = 0; root < n; ++root){
+        if(inTree[root]){
+            continue;
+        }
+        key[root] = INT_MIN;
+        pq.push(key[root], root);
+        while(!pq.empty()){
+            auto [k, u] = pq.pop();
+            if(inTree[u] || k > key[u]){
+                continue;
+            }
+            inTree[u] = 1;
+            if(parent[u] != UINT32_MAX){
+                tree.push_back({k, parent[u], u});
+            }
+            for(std::size_t e = offsets[u]; e < offsets[u + 1]; ++e){
+                uint32_t v = neighbors[e];
+                if(!inTree[v] && weights[e] < key[v]){
+                    key[v] = weights[e];
+                    parent[v] = u;
+                    pq.push(weights[e], v);
+                }
+            }
+        }
+    }
+}
+
+// Boruvka: every round each component picks its lightest outgoing edge in
+// parallel (ties broken by edge index so the picks never form a cycle), the
+// picks are merged, and edges that became internal are dropped.
+template <typename T>
+void CsrGraph<T>::getMSTBoruvka(std::vector<WeightedEdge> &tree, unsigned threads) const{
+    const std::size_t n = vertices.size();
+    threads = resolveThreadCount(threads);
+    const std::size_t grain = 4096;
+    std::vector<WeightedEdge> edges = getUndirectedEdges();
+    if(edges.size() >= UINT32_MAX){
+        throw std::length_error("Too many edges for Boruvka");
+    }
+
+    DisjointSet dsu(n);
+    std::vector<uint32_t> component(n);
+    for(uint32_t v = 0; v < n; ++v){
+        component[v] = v;
+    }
+    // (weight with the sign bit flipped, edge index), so unsigned order matches (w, index)
+    std::vector<std::atomic<uint64_t>> cheapest(n);
+    auto pack = [](int w, std::size_t index){
+        return (uint64_t(uint32_t(w) ^ 0x80000000u) << 32) | uint64_t(index);
+    };
+    auto atomicMin = [](std::atomic<uint64_t> &slot, uint64_t value){
+        uint64_t old = slot.load(std::memory_order_relaxed);
+        while(value < old && !slot.compare_exchange_weak(old, value, std::memory_order_relaxed)){}
+    };
+
+    while(!edges.empty()){
+        parallelFor(0, n, threads, grain, [&](std::size_t lo, std::size_t hi, unsigned){
+            for(std::size_t c = lo; c < hi; ++c){
+                cheapest[c].store(UINT64_MAX, std::memory_order_relaxed);
+            }
+        });
+        parallelFor(0, edges.size(), threads, grain, [&](std::size_t lo, std::size_t hi, unsigned){
+            for(std::size_t i = lo; i < hi; ++i){
+                uint32_t cu = component[edges[i].u], cv = component[edges[i].v];
+                uint64_t key = pack(edges[i].w, i);
+                atomicMin(cheapest[cu], key);
+                atomicMin(cheapest[cv], key);
+            }
+        });
+
+        bool merged = false;
+        for(std::size_t c = 0; c < n; ++c){
+            uint64_t key = cheapest[c].load(std::memory_order_relaxed);
+            if(key == UINT64_MAX){
+                continue;
+            }
+            const WeightedEdge &edge = edges[key & 0xffffffffu];
+            if(dsu.unite(edge.u, edge.v)){
+                tree.push_back(edge);
+                merged = true;
+            }
+        }
+        if(!merged){
+            break;
+        }
+
+        parallelFor(0, n, threads, grain, [&](std::size_t lo, std::size_t hi, unsigned){
+            for(std::size_t v = lo; v < hi; ++v){
+                component[v] = dsu.root(static_cast<uint32_t>(v));
+            }
+        });
+        edges.erase(std::remove_if(edges.begin(), edges.end(), [&](const WeightedEdge &edge){
+            return component[edge.u] == component[edge.v];
+        }), edges.end());
+    }
+}
+
+template <typename T>
+StronglyConnectedComponents CsrGraph<T>::getStronglyConnectedComponents(SCCAlgorithm algorithm, unsigned threads) const{
+    std::vector<uint32_t> component(vertices.size(), UINT32_MAX);
+    std::size_t count = algorithm == SCCAlgorithm::ForwardBackward
+        ? getSCCForwardBackward(component, threads)
+        : getSCCTarjan(component, 0);
+    return buildCondensation(component, count, threads);
+}
+
+// Tarjan with an explicit stack of (vertex, next arc) frames instead of
+// recursion, so path length is bounded by memory rather than the call stack.
+// Only vertices whose component is still UINT32_MAX are decomposed, numbered
+// from `count` on; the others are whole SCCs found earlier and are skipped.
+template <typename T>
+std::size_t CsrGraph<T>::getSCCTarjan(std::vector<uint32_t> &component, std::size_t count) const{
+    const uint32_t n = static_cast<uint32_t>(vertices.size());
+    const uint32_t unvisited = UINT32_MAX;
+    std::vector<uint32_t> index(n, unvisited), low(n);
+    std::vector<char> onStack(n, 0);
+    std::vector<uint32_t> sccStack;
+    std::vector<std::pair<uint32_t, std::size_t>> frames;
+    uint32_t counter = 0;
+
+    for(uint32_t root = 0; root < n; ++root){
+        if(index[root] != unvisited || component[root] != unvisited){
+            continue;
+        }
+        frames.push_back({root, offsets[root]});
+        index[root] = low[root] = counter++;
+        sccStack.push_back(root);
+        onStack[root] = 1;
+
+        while(!frames.empty()){
+            auto &[u, e] = frames.back();
+            if(e < offsets[u + 1]){
+                uint32_t v = neighbors[e++];
+                if(index[v] == unvisited && component[v] == unvisited){
+                    index[v] = low[v] = counter++;
+                    sccStack.push_back(v);
+                    onStack[v] = 1;
+                    frames.push_back({v, offsets[v]});
+                }
+                else if(onStack[v]){
+                    low[u] = std::min(low[u], index[v]);
+                }
+                continue;
+            }
+
+            // u is finished: pop its component if it is a root, then report to the caller frame
+            uint32_t finished = u;
+            frames.pop_back();
+            if(low[finished] == index[finished]){
+                uint32_t v;
+                do{
+                    v = sccStack.back();
+                    sccStack.pop_back();
+                    onStack[v] = 0;
+                    component[v] = static_cast<uint32_t>(count);
+                }while(v != finished);
+                count++;
+            }
+            if(!frames.empty()){
+                uint32_t caller = frames.back().first;
+                low[caller] = std::min(low[caller], low[finished]);
+            }
+        }
+    }
+    return count;
+}
+
+// Multi-threaded decomposition in three phases, all over the vertices that
+// have no component yet:
+//  1. trim: a vertex with no live in-arcs or no live out-arcs is its own SCC
+//  2. forward-backward from the highest degree pivot; the intersection of the
+//     two reachable sets is the pivot's SCC, usually the giant one
+//  3. coloring rounds: every vertex takes the largest id that reaches it, and
+//     a backward search from each vertex that kept its own id, restricted to
+//     its color, peels off that vertex's SCC
+// Coloring degrades on long chains of small SCCs (labels creep one hop per
+// step and the same vertices are relabelled over and over), so once a round
+// relabels too much or peels off only a sliver of what is left, the remainder
+// is finished by the sequential Tarjan.
+template <typename T>
+std::size_t CsrGraph<T>::getSCCForwardBackward(std::vector<uint32_t> &component, unsigned threads) const{
+    const uint32_t n = static_cast<uint32_t>(vertices.size());
+    const uint32_t none = UINT32_MAX;
+    threads = resolveThreadCount(threads);
+    const std::size_t grain = 1024;
+    const std::vector<std::size_t> &inOff = getInOffsets();
+    const std::vector<uint32_t> &inNbr = getInNeighbors();
+
+    std::vector<std::atomic<uint32_t>> comp(n);
+    std::atomic<uint32_t> count(0);
+    std::vector<uint32_t> live(n);
+    for(uint32_t v = 0; v < n; ++v){
+        comp[v].store(none, std::memory_order_relaxed);
+        live[v] = v;
+    }
+    auto alive = [&](uint32_t v){ return comp[v].load(std::memory_order_relaxed) == none; };
+    auto compact = [&](){
+        live.erase(std::remove_if(live.begin(), live.end(), [&](uint32_t v){ return !alive(v); }), live.end());
+    };
+    // concurrent removals only ever make a vertex look more trimmable, which is still sound
+    auto hasLiveArc = [&](uint32_t v, const std::vector<std::size_t> &off, const std::vector<uint32_t> &nbr){
+        for(std::size_t e = off[v]; e < off[v + 1]; ++e){
+            if(nbr[e] != v && alive(nbr[e])){
+                return true;
+            }
+        }
+        return false;
+    };
+    auto trim = [&](){
+        while(!live.empty()){
+            std::atomic<std::size_t> trimmed(0);
+            parallelFor(0, live.size(), threads, grain, [&](std::size_t lo, std::size_t hi, unsigned){
+                for(std::size_t i = lo; i < hi; ++i){
+                    uint32_t v = live[i];
+                    if(!hasLiveArc(v, offsets, neighbors) || !hasLiveArc(v, inOff, inNbr)){
+                        comp[v].store(count.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+                        trimmed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+            std::size_t before = live.size();
+            compact();
+            // long chains peel one vertex per round; leave them to coloring
+            if(trimmed.load() * 64 < before){
+                break;
+            }
+        }
+    };
+
+    // level-synchronous search from the given seeds over live vertices that
+    // pass `accept`, marking reached vertices in `mark` with `tag`; per-thread
+    // buffers collect the next frontier
+    std::vector<std::vector<uint32_t>> buffers(threads);
+    auto search = [&](std::vector<uint32_t> frontier, const std::vector<std::size_t> &off, const std::vector<uint32_t> &nbr,
+                      std::vector<std::atomic<uint32_t>> &mark, auto accept){
+        while(!frontier.empty()){
+            parallelFor(0, frontier.size(), threads, 256, [&](std::size_t lo, std::size_t hi, unsigned tid){
+                for(std::size_t i = lo; i < hi; ++i){
+                    uint32_t u = frontier[i];
+                    uint32_t tag = mark[u].load(std::memory_order_relaxed);
+                    for(std::size_t e = off[u]; e < off[u + 1]; ++e){
+                        uint32_t v = nbr[e];
+                        if(!alive(v) || !accept(u, v)){
+                            continue;
+                        }
+                        uint32_t expected = none;
+                        if(mark[v].compare_exchange_strong(expected, tag, std::memory_order_relaxed)){
+                            buffers[tid].push_back(v);
+                        }
+                    }
+                }
+            });
+            frontier.clear();
+            for(auto &buffer : buffers){
+                frontier.insert(frontier.end(), buffer.begin(), buffer.end());
+                buffer.clear();
+            }
+        }
+    };
+
+    trim();
+
+    std::vector<std::atomic<uint32_t>> forward(n), backward(n);
+    auto clearMarks = [&](std::vector<std::atomic<uint32_t>> &mark){
+        parallelFor(0, live.size(), threads, grain, [&](std::size_t lo, std::size_t hi, unsigned){
+            for(std::size_t i = lo; i < hi; ++i){
+                mark[live[i]].store(none, std::memory_order_relaxed);
+            }
+        });
+    };
+
+    if(!live.empty()){
+        uint32_t pivot = live[0];
+        std::size_t bestScore = 0;
+        for(uint32_t v : live){
+            std::size_t score = (offsets[v + 1] - offsets[v]) * (inOff[v + 1] - inOff[v]);
+            if(score > bestScore){
+                bestScore = score;
+                pivot = v;
+            }
+        }
+        clearMarks(forward);
+        clearMarks(backward);
+        auto any = [](uint32_t, uint32_t){ return true; };
+        forward[pivot].store(0, std::memory_order_relaxed);
+        backward[pivot].store(0, std::memory_order_relaxed);
+        search({pivot}, offsets, neighbors, forward, any);
+        search({pivot}, inOff, inNbr, backward, any);
+        uint32_t id = count.fetch_add(1, std::memory_order_relaxed);
+        parallelFor(0, live.size(), threads, grain, [&](std::size_t lo, std::size_t hi, unsigned){
+            for(std::size_t i = lo; i < hi; ++i){
+                uint32_t v = live[i];
+                if(forward[v].load(std::memory_order_relaxed) != none && backward[v].load(std::memory_order_relaxed) != none){
+                    comp[v].store(id, std::memory_order_relaxed);
+                }
+            }
+        });
+        compact();
+        trim();
+    }
+
+    std::vector<std::atomic<uint32_t>> &color = forward;
+    while(!live.empty()){
+        // propagate the largest reaching id forwards until nothing changes
+        parallelFor(0, live.size(), threads, grain, [&](std::size_t lo, std::size_t hi, unsigned){
+            for(std::size_t i = lo; i < hi; ++i){
+                color[live[i]].store(live[i], std::memory_order_relaxed);
+            }
+        });
+        clearMarks(backward);
+        std::vector<uint32_t> frontier = live;
+        std::size_t relabelled = 0;
+        while(!frontier.empty() && relabelled <= 32 * live.size()){
+            relabelled += frontier.size();
+            parallelFor(0, frontier.size(), threads, 256, [&](std::size_t lo, std::size_t hi, unsigned tid){
+                for(std::size_t i = lo; i < hi; ++i){
+                    uint32_t u = frontier[i];
+                    uint32_t c = color[u].load(std::memory_order_relaxed);
+                    for(std::size_t e = offsets[u]; e < offsets[u + 1]; ++e){
+                        uint32_t v = neighbors[e];
+                        if(!alive(v)){
+                            continue;
+                        }
+                        uint32_t old = color[v].load(std::memory_order_relaxed);
+                        while(c > old && !color[v].compare_exchange_weak(old, c, std::memory_order_relaxed)){}
+                        if(c > old){
+                            buffers[tid].push_back(v);
+                        }
+                    }
+                }
+            });
+            frontier.clear();
+            for(auto &buffer : buffers){
+                frontier.insert(frontier.end(), buffer.begin(), buffer.end());
+                buffer.clear();
+            }
+            std::sort(frontier.begin(), frontier.end());
+            frontier.erase(std::unique(frontier.begin(), frontier.end()), frontier.end());
+        }
+        if(!frontier.empty()){
+            break;
+        }
+
+        // every root r (color r == r) collects the vertices of color r that reach it
+        std::vector<uint32_t> roots;
+        for(uint32_t v : live){
+            if(color[v].load(std::memory_order_relaxed) == v){
+                roots.push_back(v);
+                backward[v].store(v, std::memory_order_relaxed);
+            }
+        }
+        search(roots, inOff, inNbr, backward, [&](uint32_t u, uint32_t v){
+            return color[v].load(std::memory_order_relaxed) == color[u].load(std::memory_order_relaxed);
+        });
+        std::vector<uint32_t> ids(roots.size());
+        for(std::size_t i = 0; i < roots.size(); ++i){
+            ids[i] = count.fetch_add(1, std::memory_order_relaxed);
+        }
+        // roots are sorted, so each vertex finds its component by binary search on its root
+        parallelFor(0, live.size(), threads, grain, [&](std::size_t lo, std::size_t hi, unsigned){
+            for(std::size_t i = lo; i < hi; ++i){
+                uint32_t v = live[i];
+                uint32_t root = backward[v].load(std::memory_order_relaxed);
+                if(root != none){
+                    comp[v].store(ids[std::lower_bound(roots.begin(), roots.end(), root) - roots.begin()], std::memory_order_relaxed);
+                }
+            }
+        });
+        std::size_t before = live.size();
+        compact();
+        if((before - live.size()) * 64 < before){
+            break;
+        }
+        trim();
+    }
+
+    component.resize(n);
+    for(uint32_t v = 0; v < n; ++v){
+        component[v] = comp[v].load(std::memory_order_relaxed);
+    }
+    return live.empty() ? count.load() : getSCCTarjan(component, count.load());
+}
+
+// Renumbers the components topologically (Kahn over the deduplicated
+// component arcs) and builds the condensation on the new ids.
+template <typename T>
+StronglyConnectedComponents CsrGraph<T>::buildCondensation(const std::vector<uint32_t> &component, std::size_t count, unsigned threads) const{
+    std::vector<WeightedEdge> arcs;
+    for(uint32_t u = 0; u < vertices.size(); ++u){
+        for(std::size_t e = offsets[u]; e < offsets[u + 1]; ++e){
+            uint32_t cu = component[u], cv = component[neighbors[e]];
+            if(cu != cv){
+                arcs.push_back({weights[e], cu, cv});
+            }
+        }
+    }
+    parallelSort(arcs.begin(), arcs.end(), threads, [](const WeightedEdge &a, const WeightedEdge &b){
+        return a.u != b.u ? a.u < b.u : a.v != b.v ? a.v < b.v : a.w < b.w;
+    });
+    arcs.erase(std::unique(arcs.begin(), arcs.end(), [](const WeightedEdge &a, const WeightedEdge &b){
+        return a.u == b.u && a.v == b.v;
+    }), arcs.end());
+
+    std::vector<std::size_t> start(count + 1, 0);
+    std::vector<uint32_t> inDegree(count, 0);
+    for(auto &arc : arcs){
+        start[arc.u + 1]++;
+        inDegree[arc.v]++;
+    }
+    for(std::size_t c = 0; c < count; ++c){
+        start[c + 1] += start[c];
+    }
+    std::vector<uint32_t> order;
+    order.reserve(count);
+    for(uint32_t c = 0; c < count; ++c){
+        if(inDegree[c] == 0){
+            order.push_back(c);
+        }
+    }
+    for(std::size_t head = 0; head < order.size(); ++head){
+        uint32_t c = order[head];
+        for(std::size_t e = start[c]; e < start[c + 1]; ++e){
+            if(--inDegree[arcs[e].v] == 0){
+                order.push_back(arcs[e].v);
+            }
+        }
+    }
+    std::vector<uint32_t> renumber(count);
+    for(uint32_t i = 0; i < count; ++i){
+        renumber[order[i]] = i;
+    }
+
+    StronglyConnectedComponents result;
+    result.count = count;
+    result.component.resize(component.size());
+    for(std::size_t v = 0; v < component.size(); ++v){
+        result.component[v] = renumber[component[v]];
+    }
+    std::vector<uint32_t> ids(count);
+    for(uint32_t c = 0; c < count; ++c){
+        ids[c] = c;
+    }
+    std::vector<std::pair<uint32_t, std::pair<uint32_t, int>>> edges;
+    edges.reserve(arcs.size());
+    for(auto &arc : arcs){
+        edges.push_back({renumber[arc.u], {renumber[arc.v], arc.w}});
+    }
+    result.condensation = CsrGraph<uint32_t>(ids, edges, true, isWeighted);
+    return result;
+}
+
+// Degrees and adjacency here are those of the undirected view: out-edges plus,
+// on directed graphs, in-edges.
+template <typename T>
+VertexOrdering CsrGraph<T>::getVertexOrdering(ReorderStrategy strategy) const{
+    const uint32_t n = static_cast<uint32_t>(vertices.size());
+    const std::vector<std::size_t> &inOff = getInOffsets();
+    const std::vector<uint32_t> &inNgb = getInNeighbors();
+    std::vector<std::size_t> degree(n);
+    for(uint32_t u = 0; u < n; ++u){
+        degree[u] = getDegree(u) + (isDirected ? inOff[u + 1] - inOff[u] : 0);
+    }
+    auto forEachNeighbor = [&](uint32_t u, auto fn){
+        for(std::size_t e = offsets[u]; e < offsets[u + 1]; ++e){
+            fn(neighbors[e]);
+        }
+        if(isDirected){
+            for(std::size_t e = inOff[u]; e < inOff[u + 1]; ++e){
+                fn(inNgb[e]);
+            }
+        }
+    };
+
+    VertexOrdering ordering;
+    std::vector<uint32_t> &order = ordering.order;
+    order.reserve(n);
+    std::vector<uint32_t> byDegree(n);
+    for(uint32_t u = 0; u < n; ++u){
+        byDegree[u] = u;
+    }
+
+    if(strategy == ReorderStrategy::DegreeDescending){
+        std::stable_sort(byDegree.begin(), byDegree.end(), [&](uint32_t a, uint32_t b){ return degree[a] > degree[b]; });
+        order = byDegree;
+    }
+    else if(strategy == ReorderStrategy::BFS){
+        std::stable_sort(byDegree.begin(), byDegree.end(), [&](uint32_t a, uint32_t b){ return degree[a] > degree[b]; });
+        std::vector<bool> placed(n, false);
+        for(uint32_t root : byDegree){
+            if(placed[root]){
+                continue;
+            }
+            placed[root] = true;
+            order.push_back(root);
+            for(std::size_t i = order.size() - 1; i < order.size(); ++i){
+                forEachNeighbor(order[i], [&](uint32_t v){
+                    if(!placed[v]){
+                        placed[v] = true;
+                        order.push_back(v);
+                    }
+                });
+            }
+        }
+    }
+    else{
+        // Cuthill-McKee from a pseudo-peripheral vertex of each component
+        // (George-Liu: hop to a lowest-degree vertex of the last BFS level
+        // while the eccentricity grows), neighbours in increasing degree.
+        std::stable_sort(byDegree.begin(), byDegree.end(), [&](uint32_t a, uint32_t b){ return degree[a] < degree[b]; });
+        std::vector<uint32_t> stamp(n, UINT32_MAX), levelOf(n), queue, next;
+        uint32_t search = 0;
+        auto lastLevel = [&](uint32_t root, std::vector<uint32_t> &last){
+            search++;
+            queue.assign(1, root);
+            stamp[root] = search;
+            levelOf[root] = 0;
+            for(std::size_t i = 0; i < queue.size(); ++i){
+                uint32_t u = queue[i];
+                forEachNeighbor(u, [&](uint32_t v){
+                    if(stamp[v] != search){
+                        stamp[v] = search;
+                        levelOf[v] = levelOf[u] + 1;
+                        queue.push_back(v);
+                    }
+                });
+            }
+            uint32_t depth = levelOf[queue.back()];
+            last.clear();
+            for(auto it = queue.rbegin(); it != queue.rend() && levelOf[*it] == depth; ++it){
+                last.push_back(*it);
+            }
+            return depth;
+        };
+
+        std::vector<bool> placed(n, false);
+        std::vector<uint32_t> last;
+        for(uint32_t start : byDegree){
+            if(placed[start]){
+                continue;
+            }
+            uint32_t root = start, depth = lastLevel(root, last);
+            for(int round = 0; round < 8; ++round){
+                uint32_t candidate = *std::min_element(last.begin(), last.end(), [&](uint32_t a, uint32_t b){ return degree[a] < degree[b]; });
+                uint32_t candidateDepth = lastLevel(candidate, last);
+                if(candidateDepth <= depth){
+                    break;
+                }
+                root = candidate;
+                depth = candidateDepth;
+            }
+
+            std::size_t begin = order.size();
+            placed[root] = true;
+            order.push_back(root);
+            for(std::size_t i = begin; i < order.size(); ++i){
+                next.clear();
+                forEachNeighbor(order[i], [&](uint32_t v){
+                    if(!placed[v]){
+                        placed[v] = true;
+                        next.push_back(v);
+                    }
+                });
+                std::stable_sort(next.begin(), next.end(), [&](uint32_t a, uint32_t b){ return degree[a] < degree[b]; });
+                order.insert(order.end(), next.begin(), next.end());
+            }
+        }
+        std::reverse(order.begin(), order.end());
+    }
+
+    ordering.rank.resize(n);
+    for(uint32_t i = 0; i < n; ++i){
+        ordering.rank[order[i]] = i;
+    }
+    return ordering;
+}
+
+template <typename T>
+CsrGraph<T> CsrGraph<T>::reorder(const VertexOrdering &ordering) const{
+    const std::size_t n = vertices.size();
+    const std::vector<uint32_t> &order = ordering.order, &rank = ordering.rank;
+    if(order.size() != n || rank.size() != n){
+        throw std::invalid_argument("Ordering must be a permutation of the vertex ids");
+    }
+    for(uint32_t i = 0; i < n; ++i){
+        if(order[i] >= n || rank[order[i]] != i){
+            throw std::invalid_argument("Ordering must be a permutation of the vertex ids");
+        }
+    }
+
+    CsrGraph<T> result;
+    result.isDirected = isDirected;
+    result.isWeighted = isWeighted;
+    result.isNegativelyWeighted = isNegativelyWeighted;
+    result.vertices.reserve(n);
+    result.vertexId.reserve(n);
+    result.offsets.assign(n + 1, 0);
+    for(uint32_t i = 0; i < n; ++i){
+        result.vertices.push_back(vertices[order[i]]);
+        result.vertexId.emplace(vertices[order[i]], i);
+        result.offsets[i + 1] = result.offsets[i] + getDegree(order[i]);
+    }
+    result.neighbors.resize(neighbors.size());
+    result.weights.resize(weights.size());
+    for(uint32_t i = 0; i < n; ++i){
+        std::size_t from = offsets[order[i]], to = result.offsets[i];
+        for(std::size_t k = 0; k < getDegree(order[i]); ++k){
+            result.neighbors[to + k] = rank[neighbors[from + k]];
+            result.weights[to + k] = weights[from + k];
+        }
+    }
+    result.sortNeighbors();
+    if(isDirected){
+        result.buildReverseIndex();
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef DisjointSet_H
+#define DisjointSet_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+// Union-find over dense uint32_t ids with union by size and path halving.
+// Two flat arrays, no per-element allocation.
+class DisjointSet {
+    private:
+        std::vector<uint32_t> parent;
+        std::vector<uint32_t> setSize;
+        std::size_t components;
+
+    public:
+        explicit DisjointSet(std::size_t n = 0) : components(0) { reset(n); }
+
+        void reset(std::size_t n){
+            parent.resize(n);
+            setSize.assign(n, 1);
+            for(std::size_t i = 0; i < n; ++i){
+                parent[i] = static_cast<uint32_t>(i);
+            }
+            components = n;
+        }
+
+        // appends a new singleton and returns its id
+        uint32_t addElement(){
+            uint32_t id = static_cast<uint32_t>(parent.size());
+            parent.push_back(id);
+            setSize.push_back(1);
+            components++;
+            return id;
+        }
+
+        uint32_t find(uint32_t x){
+            while(parent[x] != x){
+                parent[x] = parent[parent[x]];
+                x = parent[x];
+            }
+            return x;
+        }
+
+        // find without path compression, safe to call from several threads
+        uint32_t root(uint32_t x) const{
+            while(parent[x] != x){
+                x = parent[x];
+            }
+            return x;
+        }
+
+        // returns false if a and b were already in the same set
+        bool unite(uint32_t a, uint32_t b){
+            a = find(a);
+            b = find(b);
+            if(a == b){
+                return false;
+            }
+            if(setSize[a] < setSize[b]){
+                std::swap(a, b);
+            }
+            parent[b] = a;
+            setSize[a] += setSize[b];
+            components--;
+            return true;
+        }
+
+        bool connected(uint32_t a, uint32_t b) { return find(a) == find(b); }
+        std::size_t size() const { return parent.size(); }
+        std::size_t componentCount() const { return components; }
+        uint32_t componentSize(uint32_t x) { return setSize[find(x)]; }
+};
+
+#endif
@@ -0,0 +1,244 @@
+#ifndef EdgeListParser_H
+#define EdgeListParser_H
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <limits>
+#include <cstring>
+#include <climits>
+#include <cstdint>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "GraphBuilder.h"
+
+// EdgeList: one "u v [w]" per line separated by spaces, tabs or commas, with
+//           '#' or '%' comment lines. SNAP dumps are edge lists; their
+//           "# Nodes: N Edges: M" header is used to pre-size the builder.
+// Dimacs:   "c" comments, "p <kind> n m" problem line, "a u v w" (or "e u v")
+//           arcs; vertices 1..n are all added, even isolated ones.
+enum class EdgeListFormat { EdgeList, Dimacs };
+
+// Streams a text edge list into a GraphBuilder, reading fixed-size chunks and
+// parsing each complete line in place; nothing but the builder's own arc
+// buffer grows with the input. Digit runs are delimited 16 bytes at a time
+// with SSE2 where available. Vertices must be integers; a third column is
+// read as the weight when the builder is weighted and ignored otherwise.
+template <typename T>
+class EdgeListParser {
+    static_assert(std::is_integral<T>::value, "edge lists carry integer vertex ids");
+
+    private:
+        static constexpr std::size_t padding = 16; // lets SIMD loads run past the last line
+        // header counts are only hints; past this the buffers grow with the input instead
+        static constexpr std::size_t reserveLimit = std::size_t(1) << 26;
+        EdgeListFormat format;
+        std::size_t chunkSize;
+        std::size_t lineNumber;
+        std::size_t edgeCount;
+
+        static std::size_t digitRun(const char *p);
+        static bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r' || c == ','; }
+        static bool fitsVertex(long long value);
+        static void reserve(GraphBuilder<T> &builder, unsigned long long vertexCount, unsigned long long edgeCount);
+        bool nextInteger(const char *&p, const char *end, long long &value) const;
+        void parseLine(const char *p, const char *end, GraphBuilder<T> &builder);
+        void parseComment(std::string_view line, GraphBuilder<T> &builder);
+        [[noreturn]] void malformed() const;
+
+    public:
+        explicit EdgeListParser(EdgeListFormat format = EdgeListFormat::EdgeList, std::size_t chunkSize = std::size_t(1) << 22)
+            : format(format), chunkSize(std::max<std::size_t>(chunkSize, 64)), lineNumber(0), edgeCount(0) {}
+
+        // both return the number of edges handed to the builder
+        std::size_t parse(std::istream &in, GraphBuilder<T> &builder);
+        std::size_t parseFile(const std::string &path, GraphBuilder<T> &builder);
+};
+
+// length of the run of ASCII digits starting at p; the run must end before the buffer does
+template <typename T>
+std::size_t EdgeListParser<T>::digitRun(const char *p){
+#if defined(__SSE2__)
+    const __m128i below = _mm_set1_epi8('0' - 1), above = _mm_set1_epi8('9' + 1);
+    std::size_t n = 0;
+    while(true){
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + n));
+        __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(chunk, below), _mm_cmplt_epi8(chunk, above));
+        unsigned stop = ~static_cast<unsigned>(_mm_movemask_epi8(digits)) & 0xFFFFu;
+        if(stop != 0){
+            return n + __builtin_ctz(stop);
+        }
+        n += 16;
+    }
+#else
+    std::size_t n = 0;
+    while(p[n] >= '0' && p[n] <= '9'){
+        n++;
+    }
+    return n;
+#endif
+}
+
+template <typename T>
+bool EdgeListParser<T>::nextInteger(const char *&p, const char *end, long long &value) const{
+    while(p < end && isBlank(*p)){
+        p++;
+    }
+    if(p == end){
+        return false;
+    }
+    bool negative = *p == '-';
+    if(negative || *p == '+'){
+        p++;
+    }
+    std::size_t length = digitRun(p);
+    if(length == 0 || length > 18){
+        malformed();
+    }
+    long long v = 0;
+    for(std::size_t i = 0; i < length; ++i){
+        v = v * 10 + (p[i] - '0');
+    }
+    p += length;
+    if(p < end && !isBlank(*p)){
+        malformed();
+    }
+    value = negative ? -v : v;
+    return true;
+}
+
+// whether value is representable as T, so the cast cannot alias another vertex
+template <typename T>
+bool EdgeListParser<T>::fitsVertex(long long value){
+    if(value < 0){
+        return std::numeric_limits<T>::is_signed && value >= static_cast<long long>(std::numeric_limits<T>::min());
+    }
+    return static_cast<unsigned long long>(value) <= static_cast<unsigned long long>(std::numeric_limits<T>::max());
+}
+
+template <typename T>
+void EdgeListParser<T>::reserve(GraphBuilder<T> &builder, unsigned long long vertexCount, unsigned long long edgeCount){
+    builder.reserve(static_cast<std::size_t>(std::min<unsigned long long>(vertexCount, reserveLimit)),
+                    builder.getEdgeCount() + static_cast<std::size_t>(std::min<unsigned long long>(edgeCount, reserveLimit)));
+}
+
+template <typename T>
+void EdgeListParser<T>::malformed() const{
+    throw std::runtime_error("Malformed edge list at line " + std::to_string(lineNumber));
+}
+
+template <typename T>
+void EdgeListParser<T>::parseComment(std::string_view line, GraphBuilder<T> &builder){
+    std::size_t nodes = line.find("Nodes:"), edges = line.find("Edges:");
+    if(nodes == std::string_view::npos || edges == std::string_view::npos){
+        return;
+    }
+    unsigned long long n = std::strtoull(line.data() + nodes + 6, nullptr, 10);
+    unsigned long long m = std::strtoull(line.data() + edges + 6, nullptr, 10);
+    reserve(builder, n, m);
+}
+
+template <typename T>
+void EdgeListParser<T>::parseLine(const char *p, const char *end, GraphBuilder<T> &builder){
+    while(p < end && isBlank(*p)){
+        p++;
+    }
+    if(p == end){
+        return;
+    }
+
+    if(format == EdgeListFormat::EdgeList){
+        if(*p == '#' || *p == '%'){
+            parseComment(std::string_view(p, end - p), builder);
+            return;
+        }
+    }
+    else{
+        char kind = *p++;
+        if(kind == 'c'){
+            return;
+        }
+        if(kind == 'p'){
+            while(p < end && (isBlank(*p) || (*p >= 'a' && *p <= 'z'))){
+                p++; // problem kind, e.g. "sp" or "edge"
+            }
+            long long n, m;
+            // vertices 1..n must be valid T values and fit the graph's 32-bit ids
+            if(!nextInteger(p, end, n) || !nextInteger(p, end, m) || n < 0 || m < 0
+               || n > static_cast<long long>(UINT32_MAX) || !fitsVertex(n)){
+                malformed();
+            }
+            reserve(builder, static_cast<unsigned long long>(n), static_cast<unsigned long long>(m));
+            for(long long v = 1; v <= n; ++v){
+                builder.addVertex(static_cast<T>(v));
+            }
+            return;
+        }
+        if(kind != 'a' && kind != 'e'){
+            malformed();
+        }
+    }
+
+    long long u, v, w = 1;
+    if(!nextInteger(p, end, u) || !nextInteger(p, end, v) || !fitsVertex(u) || !fitsVertex(v)){
+        malformed();
+    }
+    if(builder.weighted() && nextInteger(p, end, w) && (w < INT_MIN || w > INT_MAX)){
+        malformed();
+    }
+    builder.addEdge(static_cast<T>(u), static_cast<T>(v), static_cast<int>(w));
+    edgeCount++;
+}
+
+template <typename T>
+std::size_t EdgeListParser<T>::parse(std::istream &in, GraphBuilder<T> &builder){
+    lineNumber = 0;
+    edgeCount = 0;
+    std::vector<char> buffer(chunkSize + padding);
+    std::size_t carried = 0; // bytes of an unfinished line kept from the last chunk
+    bool finished = false;
+    while(!finished){
+        if(carried == buffer.size() - padding){
+            buffer.resize(2 * buffer.size()); // a single line longer than the buffer
+        }
+        in.read(buffer.data() + carried, static_cast<std::streamsize>(buffer.size() - padding - carried));
+        std::size_t size = carried + static_cast<std::size_t>(in.gcount());
+        finished = !in;
+        if(finished){
+            buffer[size++] = '\n'; // close the last line, padding guarantees the room
+        }
+
+        const char *data = buffer.data();
+        const char *last = data + size;
+        while(last > data && last[-1] != '\n'){
+            last--;
+        }
+        const char *p = data;
+        while(p < last){
+            const char *eol = static_cast<const char*>(std::memchr(p, '\n', last - p));
+            lineNumber++;
+            parseLine(p, eol, builder);
+            p = eol + 1;
+        }
+        carried = size - (last - data);
+        std::memmove(buffer.data(), last, carried);
+    }
+    return edgeCount;
+}
+
+template <typename T>
+std::size_t EdgeListParser<T>::parseFile(const std::string &path, GraphBuilder<T> &builder){
+    std::ifstream in(path, std::ios::binary);
+    if(!in){
+        throw std::runtime_error("Cannot open edge list " + path);
+    }
+    return parse(in, builder);
+}
+
+#endif
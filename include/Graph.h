@@ -12,6 +12,22 @@
 #include <algorithm>
 #include <stdexcept>
 #include <utility>
+#include <functional>
+#include <climits>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include "VertexInterner.h"
+#include "Heap.h"
+#include "CsrGraph.h"
+#include "CompressedGraph.h"
+#include "ContractionHierarchy.h"
+#include "GraphAnalytics.h"
+#include "MaxFlow.h"
+#include "GraphBuilder.h"
+#include "Parallel.h"
+#include "ConnectivityIndex.h"
+#include "TraversalContext.h"
 
 struct PAIR_HASH{
     template<typename T1, typename T2>
@@ -20,92 +36,341 @@ struct PAIR_HASH{
     }
 };
 
+// Single points of failure of an undirected graph. Each biconnected component
+// lists its vertices; articulation points appear in every component they join.
+// Isolated vertices belong to no component.
+template <typename T>
+struct Biconnectivity {
+    std::vector<T> articulationPoints;
+    std::vector<std::pair<T, T>> bridges;
+    std::vector<std::vector<T>> components;
+};
+
+template <typename T>
+class ConcurrentGraph;
+
 template <typename T>
 class Graph {
     private:
-        std::unordered_map<T, std::unordered_set<std::pair<T, int> , PAIR_HASH>> adjList;
+        template <typename> friend class ConcurrentGraph;
+
+        // vertices are interned once; everything below is indexed by vertex id
+        VertexInterner<T> vertexIds;
+        std::vector<std::unordered_map<uint32_t, int>> adjList; // neighbour id -> weight
         bool isDirected;
         bool isWeighted;
-        bool isNegativelyWeighted;
-        std::unordered_map<T, bool> visited;
-       
-        void addEdgeHelper(T u, T v, int w = 1){
-            adjList[u].insert({v, w});
+        std::size_t negativeArcs; // stored arcs with a negative weight; zero lets queries use Dijkstra
+        mutable ConnectivityIndex connectivity; // optional, see enableConnectivityIndex
+        mutable TraversalContextPool contexts; // scratch for const traversals
+
+        // Guards the lazily rebuilt caches below so concurrent const queries
+        // can fill them; copies of the graph get their own mutex.
+        struct CacheMutex {
+            std::mutex mutex;
+            CacheMutex() {}
+            CacheMutex(const CacheMutex&) {}
+            CacheMutex& operator=(const CacheMutex&) { return *this; }
+        };
+        mutable CacheMutex cacheMutex;
+
+        // query caches, each valid while its stamp equals version; every
+        // structural mutation bumps version unless it can patch them in place
+        uint64_t version;
+        mutable uint64_t cycleStamp;
+        mutable bool cachedHasCycle;
+        mutable uint64_t topoDFSStamp;
+        mutable std::vector<uint32_t> topoDFSIds;
+        mutable uint64_t topoBFSStamp;
+        mutable std::vector<uint32_t> topoBFSIds;
+        bool incrementalTopo;
+        mutable std::vector<uint32_t> topoPosition; // id -> index in topoDFSIds while incrementalTopo
+        std::vector<uint32_t> topoMark;
+        uint32_t topoEpoch;
+        // directed graphs with setReverseIndex: v -> {u -> weight} for every arc u->v
+        bool reverseIndexed;
+        std::vector<std::unordered_map<uint32_t, int>> reverseList;
+
+        uint32_t internVertex(const T& v){
+            std::size_t before = vertexIds.size();
+            uint32_t id = vertexIds.intern(v);
+            if(id >= adjList.size()){
+                adjList.resize(id + 1);
+            }
+            if(reverseIndexed && id >= reverseList.size()){
+                reverseList.resize(id + 1);
+            }
+            if(vertexIds.size() != before){
+                connectivity.addVertex(id);
+                onVertexAdded(id);
+            }
+            return id;
         }
 
-        void removeEdgeHelper(T u, T v){
-            adjList[u].erase(v);
+        bool topoOrderCurrent() const{
+            return cycleStamp == version && !cachedHasCycle && topoDFSStamp == version;
+        }
+        void onVertexAdded(uint32_t id);
+        void onEdgeAdded(uint32_t u, uint32_t v);
+        void onEdgeRemoved();
+        bool maintainTopologicalOrder(uint32_t u, uint32_t v);
+        const std::vector<uint32_t>& getTopologicalIdsDFS() const;
+        const std::vector<uint32_t>& getTopologicalIdsBFS() const;
+
+        // parallel edges keep the lightest weight, returns whether the edge is new
+        bool addEdgeHelper(uint32_t u, uint32_t v, int w = 1){
+            auto [it, inserted] = adjList[u].emplace(v, w);
+            bool wasNegative = !inserted && it->second < 0;
+            if(!inserted && w < it->second){
+                it->second = w;
+            }
+            if(it->second < 0 && !wasNegative){
+                negativeArcs++;
+            }
+            if(reverseIndexed){
+                reverseList[v][u] = it->second;
+            }
+            return inserted;
         }
 
-        bool detectCycleUndirectedDFS();
-        bool detectCycleDirectedDFS();
+        // drops u -> v from adjList only
+        bool eraseArc(uint32_t u, uint32_t v){
+            auto it = adjList[u].find(v);
+            if(it == adjList[u].end()){
+                return false;
+            }
+            if(it->second < 0){
+                negativeArcs--;
+            }
+            adjList[u].erase(it);
+            return true;
+        }
 
-        void topoSortDFS(T start, std::stack<T> &s);
+        bool removeEdgeHelper(uint32_t u, uint32_t v){
+            bool removed = eraseArc(u, v);
+            if(removed && reverseIndexed){
+                reverseList[v].erase(u);
+            }
+            return removed;
+        }
 
-        void getDistanceTopoDFS(T start, std::vector<std::pair<T, int>> &disVector);
-        void getDistanceBFS(T start, std::vector<std::pair<T, int>> &disVector);
-        void getDistanceDijkstra(T start, std::vector<std::pair<T, int>> &disVector);
-        void getDistanceBellmanFord(T start, std::vector<std::pair<T, int>> &disVector);
+        void bulkLoad(const std::vector<BulkArc> &arcs, DuplicateEdgePolicy policy, unsigned threads);
+        void fillConnectivity(ConnectivityIndex &index) const;
+        void refreshConnectivity() const;
+
+        bool detectCycleUndirectedDFS() const;
+        bool detectCycleDirectedDFS() const;
+
+        void getDistanceTopoDFS(uint32_t start, std::vector<int> &distance) const;
+        void getDistanceBFS(uint32_t start, std::vector<int> &distance) const;
+        void getDistanceDijkstra(uint32_t start, std::vector<int> &distance, HeapType heap) const;
+        template <typename Heap>
+        void runDijkstra(uint32_t start, std::vector<int> &distance, Heap &pq) const;
+        bool getDistanceBellmanFord(uint32_t start, std::vector<int> &distance, std::vector<uint32_t> &parent, std::vector<uint32_t> &cycle) const;
+
+        typedef std::vector<std::unordered_map<uint32_t, int>> Adjacency;
+        // in-edges of every vertex, or nullptr when only a full scan can find them
+        const Adjacency* incomingEdges() const{
+            return !isDirected ? &adjList : reverseIndexed ? &reverseList : nullptr;
+        }
+        int getPathBFS(uint32_t source, uint32_t target, std::vector<uint32_t> &path) const;
+        int getPathDijkstra(uint32_t source, uint32_t target, std::vector<uint32_t> &path) const;
+        int getPathBidirectionalBFS(uint32_t source, uint32_t target, const Adjacency &backward, std::vector<uint32_t> &path) const;
+        int getPathBidirectionalDijkstra(uint32_t source, uint32_t target, const Adjacency &backward, std::vector<uint32_t> &path) const;
+        std::pair<int, std::vector<T>> toPathResult(int distance, const std::vector<uint32_t> &path) const;
+
+        std::vector<std::pair<T, int>> toDistanceVector(const std::vector<int> &distance) const;
 
     public:
 
-        Graph() : isDirected(false), isWeighted(false){}
-        Graph(const bool isDirected) : isDirected(isDirected), isWeighted(false){}
-        Graph(const bool isDirected, const bool isWeighted) : isDirected(isDirected), isWeighted(isWeighted) {}
+        Graph() : Graph(false, false){}
+        Graph(const bool isDirected) : Graph(isDirected, false){}
+        Graph(const bool isDirected, const bool isWeighted) : isDirected(isDirected), isWeighted(isWeighted), negativeArcs(0),
+            version(1), cycleStamp(0), cachedHasCycle(false), topoDFSStamp(0), topoBFSStamp(0), incrementalTopo(false), topoEpoch(0), reverseIndexed(false) {}
         // for unweighted graph
-        Graph(const std::vector<std::pair<T, T>>& edges, bool isDirected = false): isDirected(isDirected), isWeighted(false){
-            for(auto& [u, v] : edges){
-                addEdgeHelper(u, v, 1);
-                if(!isDirected){
-                    addEdgeHelper(v, u, 1);
-                }
-            }
+        Graph(const std::vector<std::pair<T, T>>& edges, bool isDirected = false): Graph(isDirected, false){
+            GraphBuilder<T> builder(isDirected, false);
+            builder.addEdges(edges);
+            vertexIds = std::move(builder.vertexIds);
+            bulkLoad(builder.arcs, DuplicateEdgePolicy::KeepMin, 0);
         }
         // for weighted graph
-        Graph(const std::vector<std::tuple<T, T, int>>& edges, bool isDirected = false): isDirected(isDirected), isWeighted(true){
-            for(auto& [u, v, w] : edges){
-                addEdgeHelper(u, v, w);
-                if(!isDirected){
-                    addEdgeHelper(v, u, w);
-                }
-            }
+        Graph(const std::vector<std::tuple<T, T, int>>& edges, bool isDirected = false): Graph(isDirected, true){
+            GraphBuilder<T> builder(isDirected, true);
+            builder.addEdges(edges);
+            vertexIds = std::move(builder.vertexIds);
+            bulkLoad(builder.arcs, DuplicateEdgePolicy::KeepMin, 0);
+        }
+        // bulk load everything collected by the builder, see GraphBuilder.h
+        explicit Graph(GraphBuilder<T>&& builder, DuplicateEdgePolicy policy = DuplicateEdgePolicy::KeepMin, unsigned threads = 0)
+            : Graph(builder.isDirected, builder.isWeighted){
+            vertexIds = std::move(builder.vertexIds);
+            std::vector<BulkArc> arcs = std::move(builder.arcs);
+            bulkLoad(arcs, policy, threads);
         }
 
         void addEdge(T u, T v, int w = 1);
         void removeEdge(T u, T v);
         void addVertex(T v);
         void removeVertex(T v);
-        void printGraph();
-        std::vector<T> getVertices();
-        std::vector<std::pair<T, std::pair<T, int>> > getEdges();
-        std::vector<T> getBFS(T start);
-        std::vector<T> getDFS(T start);
-        bool hasCycle();
-        std::vector<T> getTopologicalOrderDFS(); // DFS based topological order
-        std::vector<T> getTopologicalOrderBFS(); // Kahn's algorithm using bfs
-        std::vector<std::pair<T, int>> getSinglePointShortestPath(T start);
-        std::vector<std::pair<int, std::pair<T, int> >> getAllShortestPath();
-        std::vector<std::pair<T, std::pair<T, int>>> getMST();
+        // Const queries keep their traversal state in per-call contexts, so any
+        // number of threads may run them at once; mutations still need
+        // exclusive access.
+        void printGraph() const;
+        std::vector<T> getVertices() const;
+        std::vector<std::pair<T, std::pair<T, int>> > getEdges() const;
+        std::vector<T> getBFS(T start) const;
+        std::vector<T> getBFS(T start, TraversalContext &context) const; // reuses the caller's scratch
+        std::vector<std::pair<T, int>> getParallelBFS(T start, unsigned threads = 0) const; // see CsrGraph::getParallelBFS
+        // hop distances from every source, one row per source with columns in
+        // getVertices() order, -1 where unreachable; see CsrGraph::getMultiSourceBFS
+        std::vector<std::vector<int>> getMultiSourceBFS(const std::vector<T> &sources, unsigned threads = 0) const;
+        std::vector<T> getDFS(T start) const;
+        std::vector<T> getDFS(T start, TraversalContext &context) const;
+        bool hasCycle() const; // cached until the next structural mutation
+        std::vector<T> getTopologicalOrderDFS() const; // DFS based topological order
+        std::vector<T> getTopologicalOrderBFS() const; // Kahn's algorithm using bfs
+        std::vector<std::pair<T, int>> getSinglePointShortestPath(T start, HeapType heap = HeapType::LazyBinary) const;
+        std::vector<std::pair<T, int>> getSinglePointShortestPath(T start, const ShortestPathOptions &options) const;
+        std::vector<T> getNegativeCycle(T start) const; // a negative cycle reachable from start, empty if none
+        // point-to-point queries that stop as soon as target is settled;
+        // returns {distance, path}, or {-1, {}} when target is unreachable
+        std::pair<int, std::vector<T>> getShortestPath(T source, T target) const;
+        // A* for non-negative weights, heuristic(v, target) must never overestimate
+        std::pair<int, std::vector<T>> getShortestPath(T source, T target, const std::function<int(const T&, const T&)> &heuristic) const;
+        // distance matrix with rows and columns in getVertices() order, -1 where unreachable
+        std::vector<std::vector<int>> getAllShortestPath(APSPAlgorithm algorithm = APSPAlgorithm::Auto, unsigned threads = 0) const;
+        std::vector<std::pair<T, std::pair<T, int>>> getMST(MSTAlgorithm algorithm = MSTAlgorithm::Kruskal, unsigned threads = 0) const;
+        // component id per vertex (in getVertices() order) plus the condensation DAG
+        StronglyConnectedComponents getStronglyConnectedComponents(SCCAlgorithm algorithm = SCCAlgorithm::Tarjan, unsigned threads = 0) const;
+        // undirected only: articulation points, bridges and biconnected components in one pass
+        Biconnectivity<T> getBiconnectivity() const;
+        CsrGraph<T> freeze() const; // contiguous read-only snapshot for traversal-heavy workloads
+        // snapshot renumbered for locality; ordering maps freeze() ids to its ids
+        CsrGraph<T> freeze(ReorderStrategy strategy, VertexOrdering *ordering = nullptr) const;
+        // varint-encoded snapshot for graphs too large for freeze(); reordering
+        // first (see above) shrinks the encoded gaps
+        CompressedGraph<T> compress() const { return CompressedGraph<T>(freeze()); }
+        CompressedGraph<T> compress(ReorderStrategy strategy, VertexOrdering *ordering = nullptr) const { return CompressedGraph<T>(freeze(strategy, ordering)); }
+        // preprocesses the current graph for fast repeated point-to-point queries
+        ContractionHierarchy<T> buildContractionHierarchy() const;
+        // {vertex, rank} in getVertices() order; GraphAnalytics on freeze() also
+        // reports convergence and per-iteration timing
+        std::vector<std::pair<T, double>> getPageRank(const AnalyticsOptions &options = AnalyticsOptions()) const;
+        std::vector<std::pair<T, double>> getPersonalizedPageRank(const std::vector<std::pair<T, double>> &seeds, const AnalyticsOptions &options = AnalyticsOptions()) const;
+        // edge weights as capacities; flow value, per-edge flows and a minimum cut
+        MaxFlowResult<T> getMaxFlow(T source, T sink, MaxFlowAlgorithm algorithm = MaxFlowAlgorithm::PushRelabel) const;
+
+        // keeps components up to date across mutations so these queries are near O(1)
+        void enableConnectivityIndex(ConnectivityMode mode);
+        bool connected(T u, T v) const;
+        std::size_t getComponentCount() const;
+
+        // Directed graphs only: keep one topological order alive across edge and
+        // vertex inserts (Marchetti-Spaccamela et al.) instead of recomputing it.
+        // Both getTopologicalOrder* calls then return that maintained order.
+        void setIncrementalTopologicalOrder(bool enable);
+
+        // Directed graphs only: index every vertex's incoming edges as well, so
+        // removeVertex, getInDegree, getPredecessors and Kahn's in-degree pass
+        // cost O(degree) instead of a scan of the whole graph. Undirected graphs
+        // already have that for free. Point-to-point queries and unweighted
+        // single-source distances also use the index to search backwards.
+        void setReverseIndex(bool enable);
+        std::size_t getInDegree(T v) const;
+        std::size_t getOutDegree(T v) const;
+        std::vector<T> getPredecessors(T v) const;
 
 };
 
+// Counting sort of the arcs by source (load order kept within each source, so
+// KeepFirst/KeepLast see them in order), then every adjacency map is reserved
+// to its final degree and filled by one thread, with no rehashing and no
+// sharing between threads.
+template <typename T>
+void Graph<T>::bulkLoad(const std::vector<BulkArc> &arcs, DuplicateEdgePolicy policy, unsigned threads){
+    const uint32_t n = vertexIds.capacity();
+    adjList.resize(n);
+
+    std::vector<std::size_t> offsets(n + 1, 0);
+    for(auto &arc : arcs){
+        offsets[arc.u + 1]++;
+        if(!isDirected && arc.u != arc.v){
+            offsets[arc.v + 1]++;
+        }
+    }
+    for(uint32_t i = 0; i < n; ++i){
+        offsets[i + 1] += offsets[i];
+    }
+    std::vector<std::pair<uint32_t, int>> slots(offsets[n]);
+    std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+    for(auto &arc : arcs){
+        slots[cursor[arc.u]++] = {arc.v, arc.w};
+        if(!isDirected && arc.u != arc.v){
+            slots[cursor[arc.v]++] = {arc.u, arc.w};
+        }
+    }
+
+    std::atomic<bool> duplicate(false);
+    std::atomic<std::size_t> negative(0);
+    parallelFor(0, n, threads, 1024, [&](std::size_t lo, std::size_t hi, unsigned){
+        std::size_t localNegative = 0;
+        for(std::size_t u = lo; u < hi; ++u){
+            std::unordered_map<uint32_t, int> &adjacent = adjList[u];
+            adjacent.reserve(adjacent.size() + (offsets[u + 1] - offsets[u]));
+            for(std::size_t i = offsets[u]; i < offsets[u + 1]; ++i){
+                auto [it, inserted] = adjacent.emplace(slots[i].first, slots[i].second);
+                if(inserted){
+                    continue;
+                }
+                int w = slots[i].second;
+                switch(policy){
+                    case DuplicateEdgePolicy::KeepMin:
+                        it->second = std::min(it->second, w);
+                        break;
+                    case DuplicateEdgePolicy::KeepLast:
+                        it->second = w;
+                        break;
+                    case DuplicateEdgePolicy::Sum:
+                        it->second += w;
+                        break;
+                    case DuplicateEdgePolicy::Reject:
+                        duplicate.store(true, std::memory_order_relaxed);
+                        break;
+                    default:
+                        break;
+                }
+            }
+            // counted after the policy ran, since Sum and KeepLast can flip a sign
+            for(auto &[v, w] : adjacent){
+                localNegative += w < 0;
+            }
+        }
+        negative.fetch_add(localNegative, std::memory_order_relaxed);
+    });
+    negativeArcs = negative.load();
+    if(duplicate.load()){
+        throw std::invalid_argument("Duplicate edge");
+    }
+}
+
 template <typename T>
-bool Graph<T>::detectCycleUndirectedDFS(){
-    std::unordered_map<T, T> parent;
-    for(auto& [u, _] : adjList){
-        if(visited.find(u) == visited.end()){
-            visited[u] = true;
+bool Graph<T>::detectCycleUndirectedDFS() const{
+    uint32_t n = vertexIds.capacity();
+    std::vector<uint32_t> parent(n);
+    auto context = contexts.acquire();
+    context->reset(n);
+    std::vector<uint32_t> &s = context->stack;
+    for(uint32_t u = 0; u < n; ++u){
+        if(vertexIds.isAlive(u) && context->tryVisit(u)){
             parent[u] = u;
-            std::stack<T> s;
-            s.push(u);
+            s.push_back(u);
             while(!s.empty()){
-                T node = s.top();
-                s.pop();
+                uint32_t node = s.back();
+                s.pop_back();
                 for(auto& [neighbor, _] : adjList[node]){
-                    if(visited.find(neighbor) == visited.end()){
-                        visited[neighbor] = true;
+                    if(context->tryVisit(neighbor)){
                         parent[neighbor] = node;
-                        s.push(neighbor);
+                        s.push_back(neighbor);
                     }
                     else if(parent[node] != neighbor){
                         return true;
@@ -118,41 +383,43 @@ bool Graph<T>::detectCycleUndirectedDFS(){
 }
 
 template <typename T>
-bool Graph<T>:: detectCycleDirectedDFS() {
-            visited.clear();
-            std::unordered_map<T, bool> recStack;
-            std::stack<std::pair<T, bool>> s;
-
-            for (auto& [u, _] : adjList) {
-                if (visited.find(u) == visited.end()) {
+bool Graph<T>:: detectCycleDirectedDFS() const{
+            uint32_t n = vertexIds.capacity();
+            auto context = contexts.acquire();
+            context->reset(n);
+            std::vector<bool> recStack(n, false);
+            // node and whether its neighbours have already been pushed
+            std::stack<std::pair<uint32_t, bool>> s;
+
+            for (uint32_t u = 0; u < n; ++u) {
+                if (vertexIds.isAlive(u) && !context->visited(u)) {
                     s.push({u, false});
 
                     while (!s.empty()) {
-                        T node = s.top().first;
-                        bool processing = s.top().second;
+                        auto [node, processing] = s.top();
                         s.pop();
 
                         if (processing) {
                             // We're done processing this node, remove it from the recursion stack
                             recStack[node] = false;
-                        } else {
-                            if (recStack[node]) {
-                                // Node is already in the recursion stack, cycle detected
-                                return true;
-                            }
+                            continue;
+                        }
+                        if (context->visited(node)) {
+                            // reached again through another path after it finished
+                            continue;
+                        }
 
-                            // Mark this node as being processed
-                            recStack[node] = true;
-                            visited[node] = true;
-                            s.push({node, true});
-                            // Add all neighbors to the stack
-                            for (auto& [neighbor, _] : adjList[node]) {
-                                if (visited.find(neighbor) == visited.end()) {
-                                    s.push({neighbor, false});
-                                } else if (recStack[neighbor]) {
-                                    // If neighbor is in the recursion stack, we found a cycle
-                                    return true;
-                                }
+                        // Mark this node as being processed
+                        recStack[node] = true;
+                        context->visit(node);
+                        s.push({node, true});
+                        // Add all neighbors to the stack
+                        for (auto& [neighbor, _] : adjList[node]) {
+                            if (!context->visited(neighbor)) {
+                                s.push({neighbor, false});
+                            } else if (recStack[neighbor]) {
+                                // If neighbor is in the recursion stack, we found a cycle
+                                return true;
                             }
                         }
                     }
@@ -163,166 +430,207 @@ bool Graph<T>:: detectCycleDirectedDFS() {
         }
 
 template <typename T>
-void Graph<T>::topoSortDFS(T node, std::stack<T> &s){
-
-    visited[node] = 1;
-        for(auto &[v, w] : adjList[node]){
-            if(visited.find(v) == visited.end()){
-                topoSortDFS(v, s);
-            }
+std::vector<std::pair<T, int>> Graph<T>::toDistanceVector(const std::vector<int> &distance) const{
+    std::vector<std::pair<T, int>> disVector;
+    disVector.reserve(vertexIds.size());
+    for(uint32_t id = 0; id < distance.size(); ++id){
+        if(vertexIds.isAlive(id)){
+            disVector.push_back({vertexIds.getVertex(id), distance[id] == INT_MAX ? -1 : distance[id]});
         }
-        s.push(node);
-    return;
+    }
+    return disVector;
 }
 
+// Level by level; when the in-edges are at hand and the frontier's out-edges
+// outnumber both a fraction of the unexplored ones and the unreached vertices,
+// every unreached vertex looks for a parent on the current level instead
+// (Beamer et al., as in CsrGraph::getParallelBFS). The second test keeps
+// sparse graphs top-down, where scanning every vertex costs more than it saves.
 template <typename T>
-void Graph<T>::getDistanceBFS(T start, std::vector<std::pair<T, int>> &disVector)
+void Graph<T>::getDistanceBFS(uint32_t start, std::vector<int> &distance) const
 {
-    std::unordered_map<T, int> distance;
-    std::queue<T> q;
-    for (auto &[u, neighbours] : adjList)
-    {
-        distance[u] = INT_MAX;
-        for (auto &[v, w] : neighbours)
-        {
-            distance[v] = INT_MAX;
-        }
+    const Adjacency *incoming = incomingEdges();
+    const std::size_t alpha = 15, beta = 18;
+    const uint32_t n = vertexIds.capacity();
+    std::size_t unexploredEdges = 0;
+    for(uint32_t u = 0; u < n; ++u){
+        unexploredEdges += adjList[u].size();
     }
+
+    std::vector<uint32_t> frontier{start}, next;
+    std::size_t frontierEdges = adjList[start].size();
+    std::size_t unreached = vertexIds.size() - 1;
+    unexploredEdges -= frontierEdges;
     distance[start] = 0;
-    q.push(start);
-    while (!q.empty())
-    {
-        T front = q.front();
-        q.pop();
-        for (auto &[ngb, w] : adjList[front])
-        {
-            if (distance[front] + 1 < distance[ngb])
-            {
-                distance[ngb] = distance[front] + 1;
-                q.push(ngb);
+    bool bottomUp = false;
+    for(int level = 0; !frontier.empty(); ++level){
+        if(incoming != nullptr && !bottomUp && frontierEdges > unexploredEdges / alpha && frontierEdges > unreached){
+            bottomUp = true;
+        }
+        else if(bottomUp && frontier.size() < n / beta){
+            bottomUp = false;
+        }
+
+        next.clear();
+        std::size_t nextEdges = 0;
+        if(bottomUp){
+            for(uint32_t v = 0; v < n; ++v){
+                if(distance[v] != INT_MAX || !vertexIds.isAlive(v)){
+                    continue;
+                }
+                for(auto &[u, _] : (*incoming)[v]){
+                    if(distance[u] == level){
+                        distance[v] = level + 1;
+                        next.push_back(v);
+                        nextEdges += adjList[v].size();
+                        break;
+                    }
+                }
             }
         }
+        else{
+            for(uint32_t u : frontier){
+                for(auto &[ngb, _] : adjList[u]){
+                    if(distance[ngb] == INT_MAX){
+                        distance[ngb] = level + 1;
+                        next.push_back(ngb);
+                        nextEdges += adjList[ngb].size();
+                    }
+                }
+            }
+        }
+        frontier.swap(next);
+        frontierEdges = nextEdges;
+        unexploredEdges -= std::min(unexploredEdges, nextEdges);
+        unreached -= frontier.size();
     }
-    for (auto &[node, dis] : distance)
-    {
-        dis = dis == INT_MAX ? -1 : dis;
-        disVector.push_back({node, dis});
-    }
-    // return disVector;
 }
 
 template <typename T>
-void Graph<T>::getDistanceTopoDFS(T start, std::vector<std::pair<T, int>> &disVector){
-
-    visited.clear();
-    std::stack<T> st;
-    std::unordered_map<T, int> distance;
-    for (auto &[u, neighbours] : adjList){
-        distance[u] = INT_MAX;
-        for (auto &[v, w] : neighbours){
-            distance[v] = INT_MAX;
-        }
-    }
-
-    for(auto &v: getVertices()){
-        if(visited.find(v) == visited.end()){
-            topoSortDFS(v, st);
-        }
-    }
+void Graph<T>::getDistanceTopoDFS(uint32_t start, std::vector<int> &distance) const{
 
     distance[start] = 0;
 
-    while (!st.empty())
-    {
-        T top = st.top();
-        st.pop();
+    // relax in (cached) topological order, only valid on a DAG
+    for(uint32_t top : getTopologicalIdsDFS()){
+        if (distance[top] == INT_MAX){
+            continue;
+        }
         for (auto &[ngb, w] : adjList[top]){
             if (distance[top] + w < distance[ngb]){
                 distance[ngb] = distance[top] + w;
             }
         }
     }
-
-    for (auto &[node, dis] : distance){
-        dis = dis == INT_MAX ? -1 : dis;
-        disVector.push_back({node, dis});
-    }
-    // return disVector;
 }
 
 
 template <typename T>
-void Graph<T>::getDistanceDijkstra(T start, std::vector<std::pair<T, int>> &disVector){
-    std::set<std::pair<int, T>> s;
-    std::unordered_map<T, int> distance;
-
-    for(auto &[u, neighbours] : adjList){
-        distance[u] = INT_MAX;
-        for(auto &[v, w] : neighbours){
-            distance[v] = INT_MAX;
-        }
-    }
-
-    s.insert({0, start});
+template <typename Heap>
+void Graph<T>::runDijkstra(uint32_t start, std::vector<int> &distance, Heap &pq) const{
+    pq.push(0, start);
     distance[start] = 0;
 
-    while(!s.empty()){
-        auto [dis, node] = *s.begin();
-        s.erase(s.begin());
+    while(!pq.empty()){
+        auto [dis, node] = pq.pop();
+        if(dis > distance[node]){
+            // superseded by a later decrease
+            continue;
+        }
 
         for(auto &[ngb, w] : adjList[node]){
             if(dis + w < distance[ngb]){
-                if(distance[ngb] != INT_MAX){
-                    s.erase({distance[ngb], ngb});
-                }
                 distance[ngb] = dis + w;
-                s.insert({distance[ngb], ngb});
+                pq.push(distance[ngb], ngb);
             }
         }
     }
+}
 
-    for(auto &[node, dis] : distance){
-        dis = (dis == INT_MAX ? -1 : dis);
-        disVector.push_back({node, dis});
+template <typename T>
+void Graph<T>::getDistanceDijkstra(uint32_t start, std::vector<int> &distance, HeapType heap) const{
+    switch(heap){
+        case HeapType::IndexedDary: {
+            IndexedDaryHeap<4> pq(distance.size());
+            runDijkstra(start, distance, pq);
+            break;
+        }
+        case HeapType::Radix: {
+            RadixHeap pq;
+            runDijkstra(start, distance, pq);
+            break;
+        }
+        default: {
+            LazyBinaryHeap pq(distance.size());
+            runDijkstra(start, distance, pq);
+            break;
+        }
     }
 }
 
 
+// Queue based Bellman-Ford (SPFA): only vertices whose distance just dropped
+// are rescanned, so it stops as soon as a round relaxes nothing. edges[v]
+// counts the edges on the current best path to v; once it reaches V the parent
+// pointers are walked from v, and any cycle they close is a negative cycle
+// (relaxations only ever lower distances), returned through `cycle`.
 template <typename T>
-void Graph<T>::getDistanceBellmanFord(T start, std::vector<std::pair<T, int>> &disVector){
-    std::unordered_map<T, int> distance;
-
-    for(auto &[u, neighbours] : adjList){
-        distance[u] = INT_MAX;
-        for(auto &[v, w] : neighbours){
-            distance[v] = INT_MAX;
+bool Graph<T>::getDistanceBellmanFord(uint32_t start, std::vector<int> &distance, std::vector<uint32_t> &parent, std::vector<uint32_t> &cycle) const{
+    uint32_t n = vertexIds.capacity();
+    std::size_t vertexCount = vertexIds.size();
+    parent.assign(n, UINT32_MAX);
+    std::vector<std::size_t> edges(n, 0);
+    std::vector<bool> inQueue(n, false);
+    std::vector<uint32_t> seen(n, 0);
+    uint32_t stamp = 0;
+    std::queue<uint32_t> q;
+
+    auto findParentCycle = [&](uint32_t from){
+        ++stamp;
+        uint32_t x = from;
+        while(x != UINT32_MAX && seen[x] != stamp){
+            seen[x] = stamp;
+            x = parent[x];
         }
-    }
+        if(x == UINT32_MAX){
+            return false;
+        }
+        cycle.clear();
+        uint32_t y = x;
+        do{
+            cycle.push_back(y);
+            y = parent[y];
+        }while(y != x);
+        // parent pointers run backwards along the edges
+        std::reverse(cycle.begin(), cycle.end());
+        return true;
+    };
 
     distance[start] = 0;
+    q.push(start);
+    inQueue[start] = true;
 
-    for(int i=0; i<getVertices().size(); ++i){
-        for(auto &[u, ngbs] : adjList){
-            for(auto &[v, w] : ngbs){
-                if(distance[u] != INT_MAX && distance[u] + w < distance[v]){
-                    distance[v] = distance[u] + w;
+    while(!q.empty()){
+        uint32_t u = q.front();
+        q.pop();
+        inQueue[u] = false;
+
+        for(auto &[v, w] : adjList[u]){
+            if(distance[u] + w < distance[v]){
+                distance[v] = distance[u] + w;
+                parent[v] = u;
+                edges[v] = edges[u] + 1;
+                if(edges[v] >= vertexCount && findParentCycle(v)){
+                    return false;
+                }
+                if(!inQueue[v]){
+                    inQueue[v] = true;
+                    q.push(v);
                 }
             }
         }
     }
-
-    for(auto &[u, ngbs] : adjList){
-        for(auto &[v, w] : ngbs){
-            if(distance[u] != INT_MAX && distance[u] + w < distance[v]){
-                throw std::runtime_error("Graph has a negative weight cycle");
-            }
-        }
-    }
-
-    for(auto &[node, dis] : distance){
-        dis = (dis == INT_MAX ? -1 : dis);
-        disVector.push_back({node, dis});
-    }
+    return true;
 }
 
 template<typename T>
@@ -334,87 +642,143 @@ void Graph<T>::addEdge(T u, T v, int w){
         w = 1;
     }
 
-    addEdgeHelper(u, v, w);
+    uint32_t uid = internVertex(u), vid = internVertex(v);
+    bool added = addEdgeHelper(uid, vid, w);
     if(!isDirected){
-        addEdgeHelper(v, u, w);
+        addEdgeHelper(vid, uid, w);
+    }
+    if(added){
+        connectivity.addEdge(uid, vid);
+        onEdgeAdded(uid, vid);
     }
 }
 
 template<typename T>
 void Graph<T>::removeEdge(T u, T v){
-    removeEdgeHelper(u, v);
+    if(!vertexIds.contains(u) || !vertexIds.contains(v)){
+        return;
+    }
+    uint32_t uid = vertexIds.getId(u), vid = vertexIds.getId(v);
+    bool removed = removeEdgeHelper(uid, vid);
     if(!isDirected){
-        removeEdgeHelper(v, u);
+        removeEdgeHelper(vid, uid);
+    }
+    if(removed){
+        connectivity.removeEdge(uid, vid);
+        onEdgeRemoved();
     }
 }
 
 template<typename T>
 void Graph<T>::addVertex(T v){
-    if(adjList.find(v) == adjList.end()){
-        adjList[v] = {};
-    }
+    internVertex(v);
 }
 
 template<typename T>
 void Graph<T>::removeVertex(T v){
-    adjList.erase(v);
-    for(auto& [u, neighbors] : adjList){
-        neighbors.erase(v);
+    if(!vertexIds.contains(v)){
+        return;
+    }
+    uint32_t id = vertexIds.getId(v);
+    if(!isDirected){
+        for(auto& [ngb, _] : adjList[id]){
+            if(ngb != id){
+                eraseArc(ngb, id);
+            }
+        }
+    }
+    else if(reverseIndexed){
+        for(auto& [pred, _] : reverseList[id]){
+            if(pred != id){
+                eraseArc(pred, id);
+            }
+        }
+        for(auto& [ngb, _] : adjList[id]){
+            if(ngb != id){
+                reverseList[ngb].erase(id);
+            }
+        }
+        reverseList[id].clear();
+    }
+    else{
+        for(uint32_t u = 0; u < adjList.size(); ++u){
+            eraseArc(u, id);
+        }
+    }
+    for(auto& [ngb, w] : adjList[id]){
+        if(w < 0){
+            negativeArcs--;
+        }
     }
+    adjList[id].clear();
+    connectivity.removeVertex(id);
+    vertexIds.erase(v);
+    version++;
 }
 
 template<typename T>
-void Graph<T>::printGraph(){
-    for(auto& [u, neighbors] : adjList){
-        std::cout << u << " -> ";
-        for(auto& [v, w] : neighbors){
-            std::cout << "(" << v << ", " << w << ") ";
+void Graph<T>::printGraph() const{
+    for(uint32_t u = 0; u < adjList.size(); ++u){
+        if(!vertexIds.isAlive(u)){
+            continue;
+        }
+        std::cout << vertexIds.getVertex(u) << " -> ";
+        for(auto& [v, w] : adjList[u]){
+            std::cout << "(" << vertexIds.getVertex(v) << ", " << w << ") ";
         }
         std::cout << std::endl;
     }
 }
 
 template<typename T>
-std::vector<T> Graph<T>::getVertices(){
+std::vector<T> Graph<T>::getVertices() const{
     std::vector<T> vertices;
-    for(auto& [u, neighbors] : adjList){
-        vertices.push_back(u);
+    vertices.reserve(vertexIds.size());
+    for(uint32_t u = 0; u < vertexIds.capacity(); ++u){
+        if(vertexIds.isAlive(u)){
+            vertices.push_back(vertexIds.getVertex(u));
+        }
     }
     return vertices;
 }
 
 template<typename T>
-std::vector<std::pair<T, std::pair<T, int>> > Graph<T>::getEdges(){
+std::vector<std::pair<T, std::pair<T, int>> > Graph<T>::getEdges() const{
     std::vector<std::pair<T, std::pair<T, int>> > edges;
-    for(auto& [u, neighbors] : adjList){
-        for(auto& [v, w] : neighbors){
-            edges.push_back({u, {v, w}});
+    for(uint32_t u = 0; u < adjList.size(); ++u){
+        for(auto& [v, w] : adjList[u]){
+            edges.push_back({vertexIds.getVertex(u), {vertexIds.getVertex(v), w}});
         }
     }
     return edges;
 }
 
 template<typename T>
-std::vector<T> Graph<T>::getBFS(T start){
-    if(adjList.find(start) == adjList.end()){
+std::vector<T> Graph<T>::getBFS(T start) const{
+    auto context = contexts.acquire();
+    return getBFS(start, *context);
+}
+
+template<typename T>
+std::vector<T> Graph<T>::getBFS(T start, TraversalContext &context) const{
+    if(!vertexIds.contains(start)){
         throw std::invalid_argument("Vertex not found");
     }
 
     // implement BFS
     std::vector<T> bfs;
-    std::queue<T> q;
-    q.push(start);
-    visited.clear();
-    visited[start] = true;
+    uint32_t source = vertexIds.getId(start);
+    context.reset(vertexIds.capacity());
+    std::vector<uint32_t> &q = context.queue;
+    q.push_back(source);
+    context.visit(source);
     
-    while (!q.empty()){
-        T node = q.front();
-        q.pop();
-        bfs.push_back(node);
+    for(std::size_t head = 0; head < q.size(); ++head){
+        uint32_t node = q[head];
+        bfs.push_back(vertexIds.getVertex(node));
         for(auto& [neighbor, _] : adjList[node]){
-            if(visited.find(neighbor) == visited.end()){
-                visited[neighbor] = true;
-                q.push(neighbor);
+            if(context.tryVisit(neighbor)){
+                q.push_back(neighbor);
             }
         }
     }
@@ -423,26 +787,32 @@ std::vector<T> Graph<T>::getBFS(T start){
 
 
 template<typename T>
-std::vector<T> Graph<T>::getDFS(T start){
-    if(adjList.find(start) == adjList.end()){
+std::vector<T> Graph<T>::getDFS(T start) const{
+    auto context = contexts.acquire();
+    return getDFS(start, *context);
+}
+
+template<typename T>
+std::vector<T> Graph<T>::getDFS(T start, TraversalContext &context) const{
+    if(!vertexIds.contains(start)){
         throw std::invalid_argument("Vertex not found");
     }
 
     // implement DFS
     std::vector<T> dfs;
-    std::stack<T> s;
-    s.push(start);
-    visited.clear();
-    visited[start] = true;
+    uint32_t source = vertexIds.getId(start);
+    context.reset(vertexIds.capacity());
+    std::vector<uint32_t> &s = context.stack;
+    s.push_back(source);
+    context.visit(source);
     
     while (!s.empty()){
-        T node = s.top();
-        s.pop();
-        dfs.push_back(node);
+        uint32_t node = s.back();
+        s.pop_back();
+        dfs.push_back(vertexIds.getVertex(node));
         for(auto& [neighbor, _] : adjList[node]){
-            if(visited.find(neighbor) == visited.end()){
-                visited[neighbor] = true;
-                s.push(neighbor);
+            if(context.tryVisit(neighbor)){
+                s.push_back(neighbor);
             }
         }
     }
@@ -450,97 +820,108 @@ std::vector<T> Graph<T>::getDFS(T start){
 }
 
 template<typename T>
-bool Graph<T>::hasCycle(){
-    if(isDirected){
-        return detectCycleDirectedDFS();
+bool Graph<T>::hasCycle() const{
+    std::lock_guard<std::mutex> lock(cacheMutex.mutex);
+    if(cycleStamp == version){
+        return cachedHasCycle;
     }
 
-    return detectCycleUndirectedDFS();
+    cachedHasCycle = isDirected ? detectCycleDirectedDFS() : detectCycleUndirectedDFS();
+    cycleStamp = version;
+    return cachedHasCycle;
 }
 
 template<typename T>
-std::vector<T> Graph<T>::getTopologicalOrderDFS(){
-    if(hasCycle()) {
-        throw std::runtime_error("Graph has a cycle. Topological sort not possible.");
+const std::vector<uint32_t>& Graph<T>::getTopologicalIdsDFS() const{
+    std::lock_guard<std::mutex> lock(cacheMutex.mutex);
+    if(topoDFSStamp == version){
+        return topoDFSIds;
     }
 
-    visited.clear();
-    std::vector<T> topologicalOrder;
-    std::stack<std::pair<bool, T>> recStack;
-    std::stack<T> postOrder;
+    uint32_t n = vertexIds.capacity();
+    auto context = contexts.acquire();
+    context->reset(n);
+    std::stack<std::pair<bool, uint32_t>> recStack;
+    topoDFSIds.clear();
 
-    for(auto& [u, _] : adjList){
-        if(visited.find(u) == visited.end()){
-            // visited[u] = true;
+    for(uint32_t u = 0; u < n; ++u){
+        if(vertexIds.isAlive(u) && !context->visited(u)){
             recStack.push({false, u});
 
             while(!recStack.empty()){
-                std::pair<bool, T> node = recStack.top();
+                std::pair<bool, uint32_t> node = recStack.top();
                 recStack.pop();
 
                 if(node.first){
-                    postOrder.push(node.second);
+                    topoDFSIds.push_back(node.second);
                     continue;
                 }
 
-                if(visited.find(node.second) != visited.end()){
+                if(!context->tryVisit(node.second)){
                     continue;
                 }
 
-                visited[node.second] = true;
                 recStack.push({true, node.second});
                 for(auto& [neighbor, _] : adjList[node.second]){
-                    if(visited.find(neighbor) == visited.end()){
-                        // visited[neighbor] = true;
+                    if(!context->visited(neighbor)){
                         recStack.push({false, neighbor});
                     }
                 }
             }
         }
     }
+    // reversed post order
+    std::reverse(topoDFSIds.begin(), topoDFSIds.end());
 
-    while(!postOrder.empty()){
-        topologicalOrder.push_back(postOrder.top());
-        postOrder.pop();
+    if(incrementalTopo){
+        topoPosition.assign(n, 0);
+        for(uint32_t i = 0; i < topoDFSIds.size(); ++i){
+            topoPosition[topoDFSIds[i]] = i;
+        }
     }
-    return topologicalOrder;
+    topoDFSStamp = version;
+    return topoDFSIds;
 }
 
 template<typename T>
-std::vector<T> Graph<T>::getTopologicalOrderBFS() {
-    if(hasCycle()) {
-        throw std::runtime_error("Graph has a cycle. Topological sort not possible.");
+const std::vector<uint32_t>& Graph<T>::getTopologicalIdsBFS() const{
+    std::lock_guard<std::mutex> lock(cacheMutex.mutex);
+    if(topoBFSStamp == version){
+        return topoBFSIds;
     }
-    visited.clear();
-    std::vector<T> topologicalOrder;
-    std::unordered_map<T, int> inDegree;
-    std::queue<T> q;
 
-    // Initialize in-degree of all vertices to 0
-    for (auto& u : getVertices()) {
-        inDegree[u] = 0;
-    }
+    uint32_t n = vertexIds.capacity();
+    std::vector<int> inDegree(n, 0);
+    std::queue<uint32_t> q;
+    topoBFSIds.clear();
 
     // Compute in-degree of each vertex
-    for (auto& [u, neighbors] : adjList) {
-        for (auto& [v, _] : neighbors) {
-            inDegree[v]++;
+    if (reverseIndexed) {
+        for (uint32_t u = 0; u < n; ++u) {
+            inDegree[u] = static_cast<int>(reverseList[u].size());
+        }
+    }
+    else {
+        for (uint32_t u = 0; u < n; ++u) {
+            for (auto& [v, _] : adjList[u]) {
+                inDegree[v]++;
+            }
         }
     }
 
     // Push all vertices with in-degree 0 to the queue
-    for (auto& u : getVertices()) {
-        if (inDegree[u] == 0) {
+    for (uint32_t u = 0; u < n; ++u) {
+        if (vertexIds.isAlive(u) && inDegree[u] == 0) {
             q.push(u);
         }
     }
 
     // Process vertices in queue
     while (!q.empty()) {
-        T node = q.front();
+        uint32_t node = q.front();
         q.pop();
 
-        topologicalOrder.push_back(node);
+        topoBFSIds.push_back(node);
         for (auto& [neighbor, _] : adjList[node]) {
             inDegree[neighbor]--;
             if (inDegree[neighbor] == 0) {
@@ -549,45 +930,786 @@ std::vector<T> Graph<T>::getTopologicalOrderBFS() {
         }
     }
 
+    topoBFSStamp = version;
+    return topoBFSIds;
+}
+
+template<typename T>
+std::vector<T> Graph<T>::getTopologicalOrderDFS() const{
+    if(hasCycle()) {
+        throw std::runtime_error("Graph has a cycle. Topological sort not possible.");
+    }
+
+    std::vector<T> topologicalOrder;
+    topologicalOrder.reserve(vertexIds.size());
+    for(uint32_t id : getTopologicalIdsDFS()){
+        topologicalOrder.push_back(vertexIds.getVertex(id));
+    }
+    return topologicalOrder;
+}
+
+template<typename T>
+std::vector<T> Graph<T>::getTopologicalOrderBFS() const{
+    if(hasCycle()) {
+        throw std::runtime_error("Graph has a cycle. Topological sort not possible.");
+    }
+
+    const std::vector<uint32_t> &order = incrementalTopo ? getTopologicalIdsDFS() : getTopologicalIdsBFS();
+    std::vector<T> topologicalOrder;
+    topologicalOrder.reserve(order.size());
+    for(uint32_t id : order){
+        topologicalOrder.push_back(vertexIds.getVertex(id));
+    }
     return topologicalOrder;
 }
 
 template<typename T>
-std::vector<std::pair<T, int>> Graph<T>::getSinglePointShortestPath(T start){
+void Graph<T>::setIncrementalTopologicalOrder(bool enable){
+    incrementalTopo = enable && isDirected;
+    // force the next query to seed topoPosition
+    topoDFSStamp = 0;
+}
+
+template<typename T>
+void Graph<T>::setReverseIndex(bool enable){
+    reverseIndexed = enable && isDirected;
+    Adjacency().swap(reverseList);
+    if(!reverseIndexed){
+        return;
+    }
+    reverseList.resize(adjList.size());
+    for(uint32_t u = 0; u < adjList.size(); ++u){
+        for(auto& [v, w] : adjList[u]){
+            reverseList[v].emplace(u, w);
+        }
+    }
+}
+
+template<typename T>
+std::size_t Graph<T>::getInDegree(T v) const{
+    if(!vertexIds.contains(v)){
+        throw std::invalid_argument("Vertex not found");
+    }
+    uint32_t id = vertexIds.getId(v);
+    if(const Adjacency *incoming = incomingEdges()){
+        return (*incoming)[id].size();
+    }
+    std::size_t degree = 0;
+    for(auto& neighbors : adjList){
+        degree += neighbors.count(id);
+    }
+    return degree;
+}
+
+template<typename T>
+std::size_t Graph<T>::getOutDegree(T v) const{
+    if(!vertexIds.contains(v)){
+        throw std::invalid_argument("Vertex not found");
+    }
+    return adjList[vertexIds.getId(v)].size();
+}
+
+template<typename T>
+std::vector<T> Graph<T>::getPredecessors(T v) const{
+    if(!vertexIds.contains(v)){
+        throw std::invalid_argument("Vertex not found");
+    }
+    uint32_t id = vertexIds.getId(v);
+    std::vector<T> predecessors;
+    if(const Adjacency *incoming = incomingEdges()){
+        predecessors.reserve((*incoming)[id].size());
+        for(auto& [u, _] : (*incoming)[id]){
+            predecessors.push_back(vertexIds.getVertex(u));
+        }
+        return predecessors;
+    }
+    for(uint32_t u = 0; u < adjList.size(); ++u){
+        if(adjList[u].count(id)){
+            predecessors.push_back(vertexIds.getVertex(u));
+        }
+    }
+    return predecessors;
+}
+
+template<typename T>
+void Graph<T>::onVertexAdded(uint32_t id){
+    bool keep = incrementalTopo && topoOrderCurrent();
+    version++;
+    if(keep){
+        // a new isolated vertex can go anywhere, the end is cheapest
+        if(id >= topoPosition.size()){
+            topoPosition.resize(id + 1);
+        }
+        topoPosition[id] = static_cast<uint32_t>(topoDFSIds.size());
+        topoDFSIds.push_back(id);
+        cycleStamp = topoDFSStamp = version;
+    }
+}
+
+template<typename T>
+void Graph<T>::onEdgeAdded(uint32_t u, uint32_t v){
+    bool keep = incrementalTopo && topoOrderCurrent();
+    version++;
+    if(!keep){
+        return;
+    }
+    if(maintainTopologicalOrder(u, v)){
+        cycleStamp = topoDFSStamp = version;
+    }
+    else{
+        // the order is gone, but we learned the answer to hasCycle()
+        cachedHasCycle = true;
+        cycleStamp = version;
+    }
+}
+
+template<typename T>
+void Graph<T>::onEdgeRemoved(){
+    // a DAG minus an edge is still a DAG and the old order still fits it
+    bool keep = incrementalTopo && topoOrderCurrent();
+    version++;
+    if(keep){
+        cycleStamp = topoDFSStamp = version;
+    }
+}
+
+// Marchetti-Spaccamela, Nanni & Rohnert: for a new edge u->v that points
+// backwards in the order, search forward from v through the window
+// [pos(v), pos(u)]. Reaching u means a cycle; otherwise the reached vertices
+// move, in their old relative order, to the end of the window.
+template<typename T>
+bool Graph<T>::maintainTopologicalOrder(uint32_t u, uint32_t v){
+    if(u == v){
+        return false;
+    }
+    uint32_t lo = topoPosition[v], hi = topoPosition[u];
+    if(hi < lo){
+        return true;
+    }
+
+    if(topoMark.size() < vertexIds.capacity()){
+        topoMark.resize(vertexIds.capacity(), 0);
+    }
+    if(++topoEpoch == 0){
+        std::fill(topoMark.begin(), topoMark.end(), 0);
+        topoEpoch = 1;
+    }
+
+    std::vector<uint32_t> reached{v};
+    std::vector<uint32_t> stack{v};
+    topoMark[v] = topoEpoch;
+    while(!stack.empty()){
+        uint32_t x = stack.back();
+        stack.pop_back();
+        for(auto &[y, _] : adjList[x]){
+            if(y == u){
+                return false;
+            }
+            if(topoPosition[y] <= hi && topoMark[y] != topoEpoch){
+                topoMark[y] = topoEpoch;
+                reached.push_back(y);
+                stack.push_back(y);
+            }
+        }
+    }
 
-    if(adjList.find(start) == adjList.end()){
+    std::sort(reached.begin(), reached.end(), [&](uint32_t a, uint32_t b){
+        return topoPosition[a] < topoPosition[b];
+    });
+    std::vector<uint32_t> window;
+    window.reserve(hi - lo + 1);
+    for(uint32_t p = lo; p <= hi; ++p){
+        if(topoMark[topoDFSIds[p]] != topoEpoch){
+            window.push_back(topoDFSIds[p]);
+        }
+    }
+    window.insert(window.end(), reached.begin(), reached.end());
+    for(uint32_t i = 0; i < window.size(); ++i){
+        topoDFSIds[lo + i] = window[i];
+        topoPosition[window[i]] = lo + i;
+    }
+    return true;
+}
+
+template<typename T>
+std::vector<std::pair<T, int>> Graph<T>::getSinglePointShortestPath(T start, HeapType heap) const{
+
+    if(!vertexIds.contains(start)){
         throw std::invalid_argument("Vertex not found");
     }
 
-    std::vector<std::pair<T, int>> distances;
+    uint32_t source = vertexIds.getId(start);
+    std::vector<int> distance(vertexIds.capacity(), INT_MAX);
     if(!isWeighted){
-        if(hasCycle()){
-            // for directed Acyclic graph TC: O(V+E)
-            getDistanceTopoDFS(start, distances);
+        // for unweighted graph TC: O(V+E)
+        getDistanceBFS(source, distance);
+    }
+    else{
+        if(negativeArcs > 0){
+            if(isDirected && !hasCycle()){
+                // for directed Acyclic graph TC: O(V+E)
+                getDistanceTopoDFS(source, distance);
+            }else{
+                // for negative weights TC: O(VE)
+                std::vector<uint32_t> parent, cycle;
+                if(!getDistanceBellmanFord(source, distance, parent, cycle)){
+                    throw std::runtime_error("Graph has a negative weight cycle");
+                }
+            }
         }else{
-            // for unweighted graph TC: O(V+E)
-            getDistanceBFS(start, distances);
+            // for any graph which is not dense TC: O(E+V)logV, heap picks the queue backend
+            getDistanceDijkstra(source, distance, heap);
         }
     }
+
+    return toDistanceVector(distance);
+}
+
+template<typename T>
+std::vector<T> Graph<T>::getNegativeCycle(T start) const{
+    if(!vertexIds.contains(start)){
+        throw std::invalid_argument("Vertex not found");
+    }
+    std::vector<int> distance(vertexIds.capacity(), INT_MAX);
+    std::vector<uint32_t> parent, cycle;
+    std::vector<T> negativeCycle;
+    if(!getDistanceBellmanFord(vertexIds.getId(start), distance, parent, cycle)){
+        for(uint32_t id : cycle){
+            negativeCycle.push_back(vertexIds.getVertex(id));
+        }
+    }
+    return negativeCycle;
+}
+
+template<typename T>
+std::pair<int, std::vector<T>> Graph<T>::toPathResult(int distance, const std::vector<uint32_t> &path) const{
+    std::vector<T> vertices;
+    vertices.reserve(path.size());
+    for(uint32_t id : path){
+        vertices.push_back(vertexIds.getVertex(id));
+    }
+    return {distance, vertices};
+}
+
+// follows parent pointers back from target, returns the path source..target
+inline std::vector<uint32_t> unwindPath(const std::vector<uint32_t> &parent, uint32_t source, uint32_t target){
+    std::vector<uint32_t> path;
+    for(uint32_t x = target; x != source; x = parent[x]){
+        path.push_back(x);
+    }
+    path.push_back(source);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+template<typename T>
+std::pair<int, std::vector<T>> Graph<T>::getShortestPath(T source, T target) const{
+    if(!vertexIds.contains(source) || !vertexIds.contains(target)){
+        throw std::invalid_argument("Vertex not found");
+    }
+    uint32_t s = vertexIds.getId(source), t = vertexIds.getId(target);
+    std::vector<uint32_t> path;
+    int distance;
+
+    if(!isWeighted){
+        distance = getPathBFS(s, t, path);
+    }
+    else if(negativeArcs == 0){
+        distance = getPathDijkstra(s, t, path);
+    }
     else{
-        if(isNegativelyWeighted){
-            // for negative weights TC: O(VE)
-            getDistanceBellmanFord(start, distances);
-        }else{
-            // for any graph which is not dense TC: O(E+V)logV
-            getDistanceDijkstra(start, distances);
+        // negative weights rule out early exit, run the full SPFA and unwind
+        std::vector<int> dist(vertexIds.capacity(), INT_MAX);
+        std::vector<uint32_t> parent, cycle;
+        if(!getDistanceBellmanFord(s, dist, parent, cycle)){
+            throw std::runtime_error("Graph has a negative weight cycle");
+        }
+        distance = dist[t] == INT_MAX ? -1 : dist[t];
+        if(distance != -1){
+            path = unwindPath(parent, s, t);
         }
     }
+    return toPathResult(distance, path);
+}
+
+template<typename T>
+int Graph<T>::getPathBFS(uint32_t source, uint32_t target, std::vector<uint32_t> &path) const{
+    if(const Adjacency *incoming = incomingEdges()){
+        return getPathBidirectionalBFS(source, target, *incoming, path);
+    }
 
-    return distances;
+    std::vector<uint32_t> parent(vertexIds.capacity(), UINT32_MAX);
+    std::vector<int> distance(vertexIds.capacity(), -1);
+    std::queue<uint32_t> q;
+    distance[source] = 0;
+    q.push(source);
+    while(!q.empty() && distance[target] == -1){
+        uint32_t node = q.front();
+        q.pop();
+        for(auto &[ngb, _] : adjList[node]){
+            if(distance[ngb] == -1){
+                distance[ngb] = distance[node] + 1;
+                parent[ngb] = node;
+                q.push(ngb);
+            }
+        }
+    }
+    if(distance[target] != -1){
+        path = unwindPath(parent, source, target);
+    }
+    return distance[target];
+}
+
+template<typename T>
+int Graph<T>::getPathDijkstra(uint32_t source, uint32_t target, std::vector<uint32_t> &path) const{
+    if(const Adjacency *incoming = incomingEdges()){
+        return getPathBidirectionalDijkstra(source, target, *incoming, path);
+    }
+
+    std::vector<uint32_t> parent(vertexIds.capacity(), UINT32_MAX);
+    std::vector<int> distance(vertexIds.capacity(), INT_MAX);
+    LazyBinaryHeap pq;
+    distance[source] = 0;
+    pq.push(0, source);
+    while(!pq.empty()){
+        auto [dis, node] = pq.pop();
+        if(dis > distance[node]){
+            continue;
+        }
+        if(node == target){
+            break;
+        }
+        for(auto &[ngb, w] : adjList[node]){
+            if(dis + w < distance[ngb]){
+                distance[ngb] = dis + w;
+                parent[ngb] = node;
+                pq.push(distance[ngb], ngb);
+            }
+        }
+    }
+    if(distance[target] == INT_MAX){
+        return -1;
+    }
+    path = unwindPath(parent, source, target);
+    return distance[target];
+}
+
+// Grows a BFS ball from each end, always a whole level of the smaller
+// frontier at a time. Once a level touches the other ball, the best meeting
+// vertex of that level gives the shortest path.
+template<typename T>
+int Graph<T>::getPathBidirectionalBFS(uint32_t source, uint32_t target, const Adjacency &backward, std::vector<uint32_t> &path) const{
+    uint32_t n = vertexIds.capacity();
+    std::vector<int> distance[2] = {std::vector<int>(n, -1), std::vector<int>(n, -1)};
+    std::vector<uint32_t> parent[2] = {std::vector<uint32_t>(n, UINT32_MAX), std::vector<uint32_t>(n, UINT32_MAX)};
+    std::vector<uint32_t> frontier[2] = {{source}, {target}};
+    const Adjacency *adjacency[2] = {&adjList, &backward};
+    distance[0][source] = 0;
+    distance[1][target] = 0;
+
+    int best = source == target ? 0 : INT_MAX;
+    uint32_t meet = source;
+    while(best == INT_MAX && !frontier[0].empty() && !frontier[1].empty()){
+        int side = frontier[0].size() <= frontier[1].size() ? 0 : 1;
+        std::vector<uint32_t> next;
+        for(uint32_t u : frontier[side]){
+            for(auto &[v, _] : (*adjacency[side])[u]){
+                if(distance[side][v] != -1){
+                    continue;
+                }
+                distance[side][v] = distance[side][u] + 1;
+                parent[side][v] = u;
+                next.push_back(v);
+                if(distance[1 - side][v] != -1 && distance[0][v] + distance[1][v] < best){
+                    best = distance[0][v] + distance[1][v];
+                    meet = v;
+                }
+            }
+        }
+        frontier[side].swap(next);
+    }
+    if(best == INT_MAX){
+        return -1;
+    }
+
+    path = unwindPath(parent[0], source, meet);
+    for(uint32_t x = meet; x != target; ){
+        x = parent[1][x];
+        path.push_back(x);
+    }
+    return best;
+}
+
+// Runs Dijkstra from both ends, advancing whichever queue has the smaller
+// head. best tracks the lightest source-target path seen through any vertex
+// labelled by both searches; once the two heads add up to at least best,
+// nothing shorter can remain.
+template<typename T>
+int Graph<T>::getPathBidirectionalDijkstra(uint32_t source, uint32_t target, const Adjacency &backward, std::vector<uint32_t> &path) const{
+    uint32_t n = vertexIds.capacity();
+    std::vector<int> distance[2] = {std::vector<int>(n, INT_MAX), std::vector<int>(n, INT_MAX)};
+    std::vector<uint32_t> parent[2] = {std::vector<uint32_t>(n, UINT32_MAX), std::vector<uint32_t>(n, UINT32_MAX)};
+    LazyBinaryHeap pq[2];
+    const Adjacency *adjacency[2] = {&adjList, &backward};
+    distance[0][source] = 0;
+    distance[1][target] = 0;
+    pq[0].push(0, source);
+    pq[1].push(0, target);
+
+    long long best = source == target ? 0 : LLONG_MAX;
+    uint32_t meet = source;
+    while(!pq[0].empty() && !pq[1].empty()){
+        if(static_cast<long long>(pq[0].top().first) + pq[1].top().first >= best){
+            break;
+        }
+        int side = pq[0].top().first <= pq[1].top().first ? 0 : 1;
+        auto [dis, u] = pq[side].pop();
+        if(dis > distance[side][u]){
+            continue;
+        }
+        for(auto &[v, w] : (*adjacency[side])[u]){
+            if(dis + w < distance[side][v]){
+                distance[side][v] = dis + w;
+                parent[side][v] = u;
+                pq[side].push(distance[side][v], v);
+            }
+            if(distance[1 - side][v] != INT_MAX){
+                long long through = static_cast<long long>(distance[0][v]) + distance[1][v];
+                if(through < best){
+                    best = through;
+                    meet = v;
+                }
+            }
+        }
+    }
+    if(best == LLONG_MAX){
+        return -1;
+    }
+
+    path = unwindPath(parent[0], source, meet);
+    for(uint32_t x = meet; x != target; ){
+        x = parent[1][x];
+        path.push_back(x);
+    }
+    return static_cast<int>(best);
 }
 
+template<typename T>
+std::pair<int, std::vector<T>> Graph<T>::getShortestPath(T source, T target, const std::function<int(const T&, const T&)> &heuristic) const{
+    if(!vertexIds.contains(source) || !vertexIds.contains(target)){
+        throw std::invalid_argument("Vertex not found");
+    }
+    if(negativeArcs > 0){
+        throw std::invalid_argument("A* requires non-negative weights");
+    }
+
+    uint32_t s = vertexIds.getId(source), t = vertexIds.getId(target);
+    uint32_t n = vertexIds.capacity();
+    std::vector<int> distance(n, INT_MAX);
+    std::vector<int> estimate(n, -1); // heuristic, evaluated once per vertex
+    std::vector<uint32_t> parent(n, UINT32_MAX);
+    auto h = [&](uint32_t v){
+        if(estimate[v] < 0){
+            estimate[v] = std::max(0, heuristic(vertexIds.getVertex(v), target));
+        }
+        return estimate[v];
+    };
+
+    // keyed by distance + heuristic; a vertex is reopened whenever its distance drops
+    LazyBinaryHeap pq;
+    distance[s] = 0;
+    pq.push(h(s), s);
+    while(!pq.empty()){
+        auto [f, u] = pq.pop();
+        if(f > distance[u] + h(u)){
+            continue;
+        }
+        if(u == t){
+            break;
+        }
+        for(auto &[v, w] : adjList[u]){
+            if(distance[u] + w < distance[v]){
+                distance[v] = distance[u] + w;
+                parent[v] = u;
+                pq.push(distance[v] + h(v), v);
+            }
+        }
+    }
+
+    std::vector<uint32_t> path;
+    if(distance[t] == INT_MAX){
+        return toPathResult(-1, path);
+    }
+    return toPathResult(distance[t], unwindPath(parent, s, t));
+}
+
+// delta-stepping runs on a frozen snapshot, the sequential engines run in place
+template<typename T>
+std::vector<std::pair<T, int>> Graph<T>::getSinglePointShortestPath(T start, const ShortestPathOptions &options) const{
+    if(!options.deltaStepping){
+        return getSinglePointShortestPath(start, options.heap);
+    }
+    if(!vertexIds.contains(start)){
+        throw std::invalid_argument("Vertex not found");
+    }
+    return freeze().getSinglePointShortestPath(start, options);
+}
+
+// the snapshot numbers vertices in getVertices() order, so its matrix lines up
+template<typename T>
+std::vector<std::vector<int>> Graph<T>::getAllShortestPath(APSPAlgorithm algorithm, unsigned threads) const{
+    return freeze().getAllShortestPath(algorithm, threads);
+}
+
+// freezes the graph first; hold on to a CsrGraph when running many queries
+template<typename T>
+std::vector<std::pair<T, int>> Graph<T>::getParallelBFS(T start, unsigned threads) const{
+    if(!vertexIds.contains(start)){
+        throw std::invalid_argument("Vertex not found");
+    }
+    return freeze().getParallelBFS(start, threads);
+}
+
+template<typename T>
+std::vector<std::vector<int>> Graph<T>::getMultiSourceBFS(const std::vector<T> &sources, unsigned threads) const{
+    for(auto &s : sources){
+        if(!vertexIds.contains(s)){
+            throw std::invalid_argument("Vertex not found");
+        }
+    }
+    return freeze().getMultiSourceBFS(sources, threads);
+}
+
+template<typename T>
+StronglyConnectedComponents Graph<T>::getStronglyConnectedComponents(SCCAlgorithm algorithm, unsigned threads) const{
+    return freeze().getStronglyConnectedComponents(algorithm, threads);
+}
+
+template<typename T>
+CsrGraph<T> Graph<T>::freeze() const{
+    return CsrGraph<T>(getVertices(), getEdges(), isDirected, isWeighted);
+}
+
+template<typename T>
+CsrGraph<T> Graph<T>::freeze(ReorderStrategy strategy, VertexOrdering *ordering) const{
+    CsrGraph<T> snapshot = freeze();
+    VertexOrdering computed = snapshot.getVertexOrdering(strategy);
+    CsrGraph<T> reordered = snapshot.reorder(computed);
+    if(ordering != nullptr){
+        *ordering = std::move(computed);
+    }
+    return reordered;
+}
+
+template<typename T>
+ContractionHierarchy<T> Graph<T>::buildContractionHierarchy() const{
+    return ContractionHierarchy<T>(freeze());
+}
+
+template<typename T>
+std::vector<std::pair<T, double>> Graph<T>::getPageRank(const AnalyticsOptions &options) const{
+    CsrGraph<T> snapshot = freeze();
+    std::vector<double> rank = GraphAnalytics<T>(snapshot).getPageRank(options).values;
+    std::vector<std::pair<T, double>> ranks;
+    ranks.reserve(rank.size());
+    for(uint32_t id = 0; id < rank.size(); ++id){
+        ranks.push_back({snapshot.getVertex(id), rank[id]});
+    }
+    return ranks;
+}
+
+template<typename T>
+MaxFlowResult<T> Graph<T>::getMaxFlow(T source, T sink, MaxFlowAlgorithm algorithm) const{
+    if(!vertexIds.contains(source) || !vertexIds.contains(sink)){
+        throw std::invalid_argument("Vertex not found");
+    }
+    CsrGraph<T> snapshot = freeze();
+    return MaxFlow<T>(snapshot).getMaxFlow(source, sink, algorithm);
+}
+
+template<typename T>
+std::vector<std::pair<T, double>> Graph<T>::getPersonalizedPageRank(const std::vector<std::pair<T, double>> &seeds, const AnalyticsOptions &options) const{
+    for(auto &seed : seeds){
+        if(!vertexIds.contains(seed.first)){
+            throw std::invalid_argument("Vertex not found");
+        }
+    }
+    CsrGraph<T> snapshot = freeze();
+    std::vector<double> rank = GraphAnalytics<T>(snapshot).getPersonalizedPageRank(seeds, options).values;
+    std::vector<std::pair<T, double>> ranks;
+    ranks.reserve(rank.size());
+    for(uint32_t id = 0; id < rank.size(); ++id){
+        ranks.push_back({snapshot.getVertex(id), rank[id]});
+    }
+    return ranks;
+}
+
+template<typename T>
+void Graph<T>::fillConnectivity(ConnectivityIndex &index) const{
+    for(uint32_t u = 0; u < adjList.size(); ++u){
+        if(vertexIds.isAlive(u)){
+            index.addVertex(u);
+        }
+    }
+    for(uint32_t u = 0; u < adjList.size(); ++u){
+        for(auto &[v, _] : adjList[u]){
+            // undirected edges are stored twice but counted once
+            if(isDirected || u < v){
+                index.addEdge(u, v);
+            }
+        }
+    }
+}
+
+template<typename T>
+void Graph<T>::enableConnectivityIndex(ConnectivityMode mode){
+    connectivity.reset(mode);
+    fillConnectivity(connectivity);
+}
+
+// callers hold cacheMutex: finds compress paths, so even lookups write
+template<typename T>
+void Graph<T>::refreshConnectivity() const{
+    if(connectivity.needsRebuild()){
+        connectivity.reset(connectivity.getMode());
+        fillConnectivity(connectivity);
+    }
+}
+
+// without an index each call pays for a one-off union-find over every edge
+template<typename T>
+bool Graph<T>::connected(T u, T v) const{
+    if(!vertexIds.contains(u) || !vertexIds.contains(v)){
+        throw std::invalid_argument("Vertex not found");
+    }
+    uint32_t uid = vertexIds.getId(u), vid = vertexIds.getId(v);
+    if(!connectivity.enabled()){
+        ConnectivityIndex index;
+        index.reset(ConnectivityMode::InsertOnly);
+        fillConnectivity(index);
+        return index.connected(uid, vid);
+    }
+    std::lock_guard<std::mutex> lock(cacheMutex.mutex);
+    refreshConnectivity();
+    return connectivity.connected(uid, vid);
+}
+
+template<typename T>
+std::size_t Graph<T>::getComponentCount() const{
+    if(!connectivity.enabled()){
+        ConnectivityIndex index;
+        index.reset(ConnectivityMode::InsertOnly);
+        fillConnectivity(index);
+        return index.componentCount();
+    }
+    std::lock_guard<std::mutex> lock(cacheMutex.mutex);
+    refreshConnectivity();
+    return connectivity.componentCount();
+}
 
 template <typename T>
-std::vector<std::pair<T, std::pair<T, int>>> Graph<T> getMST(){
-    std::vector<std::pair<T, T>> mst;
+std::vector<std::pair<T, std::pair<T, int>>> Graph<T>::getMST(MSTAlgorithm algorithm, unsigned threads) const{
+    return freeze().getMST(algorithm, threads);
+}
+
+// Hopcroft-Tarjan low-link DFS, iterative, over the id-indexed adjacency.
+// Tree and back edges go onto an edge stack; when a child's low-link does not
+// climb above its parent, the edges down to that tree edge form one
+// biconnected component.
+template<typename T>
+Biconnectivity<T> Graph<T>::getBiconnectivity() const{
+    if(isDirected){
+        throw std::runtime_error("Graph is directed. Biconnected components are not defined.");
+    }
+
+    const uint32_t n = vertexIds.capacity();
+    const uint32_t unvisited = UINT32_MAX;
+    std::vector<uint32_t> disc(n, unvisited), low(n, 0), stamp(n, unvisited);
+    std::vector<bool> articulation(n, false);
+    std::vector<std::pair<uint32_t, uint32_t>> edgeStack;
+    struct Frame {
+        uint32_t node, parent;
+        std::unordered_map<uint32_t, int>::const_iterator next;
+    };
+    std::vector<Frame> frames;
+    Biconnectivity<T> result;
+    uint32_t counter = 0;
+
+    auto popComponent = [&](uint32_t u, uint32_t v){
+        uint32_t label = static_cast<uint32_t>(result.components.size());
+        std::vector<T> members;
+        std::pair<uint32_t, uint32_t> edge;
+        do{
+            edge = edgeStack.back();
+            edgeStack.pop_back();
+            for(uint32_t x : {edge.first, edge.second}){
+                if(stamp[x] != label){
+                    stamp[x] = label;
+                    members.push_back(vertexIds.getVertex(x));
+                }
+            }
+        }while(edge.first != u || edge.second != v);
+        result.components.push_back(std::move(members));
+    };
+
+    for(uint32_t root = 0; root < n; ++root){
+        if(!vertexIds.isAlive(root) || disc[root] != unvisited){
+            continue;
+        }
+        disc[root] = low[root] = counter++;
+        frames.push_back({root, unvisited, adjList[root].cbegin()});
+        uint32_t rootChildren = 0;
+
+        while(!frames.empty()){
+            Frame &frame = frames.back();
+            uint32_t u = frame.node;
+            if(frame.next != adjList[u].cend()){
+                uint32_t v = (frame.next++)->first;
+                if(v == u || v == frame.parent){
+                    continue; // self loop, or the tree edge back up (no parallel edges here)
+                }
+                if(disc[v] == unvisited){
+                    disc[v] = low[v] = counter++;
+                    edgeStack.push_back({u, v});
+                    if(u == root){
+                        rootChildren++;
+                    }
+                    frames.push_back({v, u, adjList[v].cbegin()});
+                }
+                else if(disc[v] < disc[u]){
+                    low[u] = std::min(low[u], disc[v]);
+                    edgeStack.push_back({u, v});
+                }
+                continue;
+            }
 
-    return mst;
+            frames.pop_back();
+            if(frames.empty()){
+                break;
+            }
+            uint32_t parent = frames.back().node;
+            low[parent] = std::min(low[parent], low[u]);
+            if(low[u] >= disc[parent]){
+                if(parent != root){
+                    articulation[parent] = true;
+                }
+                popComponent(parent, u);
+            }
+            if(low[u] > disc[parent]){
+                result.bridges.push_back({vertexIds.getVertex(parent), vertexIds.getVertex(u)});
+            }
+        }
+        if(rootChildren > 1){
+            articulation[root] = true;
+        }
+    }
+
+    for(uint32_t id = 0; id < n; ++id){
+        if(articulation[id]){
+            result.articulationPoints.push_back(vertexIds.getVertex(id));
+        }
+    }
+    return result;
 }
 
 #endif
@@ -0,0 +1,276 @@
+#ifndef GraphAnalytics_H
+#define GraphAnalytics_H
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdint>
+#include "CsrGraph.h"
+#include "Parallel.h"
+
+// Stopping rule and parallelism for the iterative analytics below. An
+// iteration's delta is the L1 change of the values (floating point) or the
+// number of vertices whose value changed (anything else).
+struct AnalyticsOptions {
+    double damping = 0.85;          // PageRank only
+    double tolerance = 1e-6;        // stop once an iteration's delta is at most this
+    std::size_t maxIterations = 100;
+    unsigned threads = 0;           // 0 uses every hardware thread
+};
+
+struct IterationStats {
+    double delta;
+    double seconds;
+    std::size_t active; // vertices computed in the iteration
+};
+
+// values[id] per snapshot vertex id, plus one IterationStats per iteration run
+template <typename Value>
+struct AnalyticsResult {
+    std::vector<Value> values;
+    std::vector<IterationStats> iterations;
+    bool converged = false;
+};
+
+// Vertex-centric iterative engine over a CsrGraph snapshot. pull() sweeps all
+// vertices each iteration, every vertex reading its in-neighbours' values
+// from the previous iteration (double buffered, so no locks or atomics); the
+// label propagation below pushes along edges from an active frontier instead,
+// so later iterations only touch vertices that still change.
+template <typename T>
+class GraphAnalytics {
+    private:
+        const CsrGraph<T> &graph;
+
+        std::vector<double> teleportFromSeeds(const std::vector<std::pair<T, double>> &seeds) const;
+        AnalyticsResult<double> runPageRank(const std::vector<double> &teleport, const AnalyticsOptions &options) const;
+
+        template <typename Value>
+        static double change(const Value &before, const Value &after){
+            if constexpr(std::is_floating_point<Value>::value){
+                return std::fabs(static_cast<double>(after - before));
+            }
+            else{
+                return before == after ? 0.0 : 1.0;
+            }
+        }
+
+    public:
+        explicit GraphAnalytics(const CsrGraph<T> &graph) : graph(graph) {}
+
+        // Runs until converged or maxIterations: prepare(current) once per
+        // iteration on the calling thread (for global terms), then
+        // next[v] = compute(v, current) for every vertex in parallel.
+        template <typename Value, typename Prepare, typename Compute>
+        AnalyticsResult<Value> pull(std::vector<Value> initial, const AnalyticsOptions &options, Prepare prepare, Compute compute) const;
+
+        // ranks sum to 1; mass of vertices without out-edges is spread like the teleport jump
+        AnalyticsResult<double> getPageRank(const AnalyticsOptions &options = AnalyticsOptions()) const;
+        // teleports only to the seeds, in proportion to their (non-negative) weights
+        AnalyticsResult<double> getPersonalizedPageRank(const std::vector<std::pair<T, double>> &seeds, const AnalyticsOptions &options = AnalyticsOptions()) const;
+        // (weakly) connected components: every vertex ends up labelled with the
+        // smallest id in its component; tolerance is ignored, it runs to a fixpoint
+        AnalyticsResult<uint32_t> getLabelPropagationComponents(const AnalyticsOptions &options = AnalyticsOptions()) const;
+};
+
+template <typename T>
+template <typename Value, typename Prepare, typename Compute>
+AnalyticsResult<Value> GraphAnalytics<T>::pull(std::vector<Value> initial, const AnalyticsOptions &options, Prepare prepare, Compute compute) const{
+    const std::size_t n = graph.getVertexCount();
+    if(initial.size() != n){
+        throw std::invalid_argument("Initial values must cover every vertex");
+    }
+    const unsigned threads = resolveThreadCount(options.threads);
+    AnalyticsResult<Value> result;
+    result.values = std::move(initial);
+    std::vector<Value> next(n);
+    // one cache line per thread so the partial sums do not false-share
+    struct alignas(64) Partial { double delta; };
+    std::vector<Partial> partial(threads);
+
+    for(std::size_t iteration = 0; iteration < options.maxIterations; ++iteration){
+        auto start = std::chrono::steady_clock::now();
+        prepare(static_cast<const std::vector<Value>&>(result.values));
+        for(auto &p : partial){
+            p.delta = 0;
+        }
+        const std::vector<Value> &current = result.values;
+        parallelFor(0, n, threads, 1024, [&](std::size_t lo, std::size_t hi, unsigned tid){
+            double delta = 0;
+            for(std::size_t v = lo; v < hi; ++v){
+                next[v] = compute(static_cast<uint32_t>(v), current);
+                delta += change(current[v], next[v]);
+            }
+            partial[tid].delta += delta;
+        });
+        result.values.swap(next);
+
+        double delta = 0;
+        for(auto &p : partial){
+            delta += p.delta;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        result.iterations.push_back({delta, elapsed.count(), n});
+        if(delta <= options.tolerance){
+            result.converged = true;
+            break;
+        }
+    }
+    return result;
+}
+
+template <typename T>
+AnalyticsResult<double> GraphAnalytics<T>::runPageRank(const std::vector<double> &teleport, const AnalyticsOptions &options) const{
+    const std::size_t n = graph.getVertexCount();
+    if(n == 0){
+        AnalyticsResult<double> empty;
+        empty.converged = true;
+        return empty;
+    }
+    const std::vector<std::size_t> &offsets = graph.getOffsets();
+    const std::vector<std::size_t> &inOffsets = graph.getInOffsets();
+    const std::vector<uint32_t> &inNeighbors = graph.getInNeighbors();
+    const double d = options.damping;
+
+    // contribution[u] = rank[u] / outdeg(u), refreshed before each sweep
+    std::vector<double> contribution(n);
+    double danglingMass = 0;
+    auto prepare = [&](const std::vector<double> &rank){
+        danglingMass = 0;
+        for(std::size_t u = 0; u < n; ++u){
+            std::size_t degree = offsets[u + 1] - offsets[u];
+            if(degree == 0){
+                danglingMass += rank[u];
+                contribution[u] = 0;
+            }
+            else{
+                contribution[u] = rank[u] / static_cast<double>(degree);
+            }
+        }
+    };
+    auto compute = [&](uint32_t v, const std::vector<double>&){
+        double sum = 0;
+        for(std::size_t e = inOffsets[v]; e < inOffsets[v + 1]; ++e){
+            sum += contribution[inNeighbors[e]];
+        }
+        return (1 - d + d * danglingMass) * teleport[v] + d * sum;
+    };
+    return pull(teleport, options, prepare, compute);
+}
+
+template <typename T>
+AnalyticsResult<double> GraphAnalytics<T>::getPageRank(const AnalyticsOptions &options) const{
+    const std::size_t n = graph.getVertexCount();
+    return runPageRank(std::vector<double>(n, n == 0 ? 0.0 : 1.0 / static_cast<double>(n)), options);
+}
+
+template <typename T>
+std::vector<double> GraphAnalytics<T>::teleportFromSeeds(const std::vector<std::pair<T, double>> &seeds) const{
+    std::vector<double> teleport(graph.getVertexCount(), 0.0);
+    double total = 0;
+    for(auto &[v, weight] : seeds){
+        if(weight < 0){
+            throw std::invalid_argument("Seed weights must be non-negative");
+        }
+        teleport[graph.getId(v)] += weight;
+        total += weight;
+    }
+    if(total <= 0){
+        throw std::invalid_argument("Personalized PageRank needs a seed with positive weight");
+    }
+    for(double &t : teleport){
+        t /= total;
+    }
+    return teleport;
+}
+
+template <typename T>
+AnalyticsResult<double> GraphAnalytics<T>::getPersonalizedPageRank(const std::vector<std::pair<T, double>> &seeds, const AnalyticsOptions &options) const{
+    return runPageRank(teleportFromSeeds(seeds), options);
+}
+
+// Min-label propagation along out- and in-edges. Each iteration the active
+// vertices push their label to every neighbour with an atomic min; whoever
+// lowers a label activates that neighbour for the next iteration.
+template <typename T>
+AnalyticsResult<uint32_t> GraphAnalytics<T>::getLabelPropagationComponents(const AnalyticsOptions &options) const{
+    const std::size_t n = graph.getVertexCount();
+    const unsigned threads = resolveThreadCount(options.threads);
+    const std::vector<std::size_t> &offsets = graph.getOffsets();
+    const std::vector<uint32_t> &neighbors = graph.getNeighbors();
+    const std::vector<std::size_t> &inOffsets = graph.getInOffsets();
+    const std::vector<uint32_t> &inNeighbors = graph.getInNeighbors();
+
+    std::vector<std::atomic<uint32_t>> label(n);
+    std::vector<std::atomic<uint8_t>> queued(n); // marks membership of the next frontier
+    std::vector<uint32_t> frontier(n);
+    for(uint32_t v = 0; v < n; ++v){
+        label[v].store(v, std::memory_order_relaxed);
+        queued[v].store(0, std::memory_order_relaxed);
+        frontier[v] = v;
+    }
+    std::vector<std::vector<uint32_t>> buffers(threads);
+
+    AnalyticsResult<uint32_t> result;
+    auto lower = [&](uint32_t v, uint32_t value, std::vector<uint32_t> &out){
+        uint32_t seen = label[v].load(std::memory_order_relaxed);
+        while(value < seen){
+            if(label[v].compare_exchange_weak(seen, value, std::memory_order_relaxed)){
+                if(queued[v].exchange(1, std::memory_order_relaxed) == 0){
+                    out.push_back(v);
+                }
+                return true;
+            }
+        }
+        return false;
+    };
+
+    for(std::size_t iteration = 0; iteration < options.maxIterations && !frontier.empty(); ++iteration){
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::size_t> changed(threads, 0);
+        parallelFor(0, frontier.size(), threads, 256, [&](std::size_t lo, std::size_t hi, unsigned tid){
+            std::vector<uint32_t> &out = buffers[tid];
+            for(std::size_t i = lo; i < hi; ++i){
+                uint32_t u = frontier[i];
+                uint32_t mine = label[u].load(std::memory_order_relaxed);
+                for(std::size_t e = offsets[u]; e < offsets[u + 1]; ++e){
+                    changed[tid] += lower(neighbors[e], mine, out);
+                }
+                if(graph.directed()){
+                    for(std::size_t e = inOffsets[u]; e < inOffsets[u + 1]; ++e){
+                        changed[tid] += lower(inNeighbors[e], mine, out);
+                    }
+                }
+            }
+        });
+
+        std::size_t active = frontier.size();
+        frontier.clear();
+        for(auto &out : buffers){
+            frontier.insert(frontier.end(), out.begin(), out.end());
+            out.clear();
+        }
+        for(uint32_t v : frontier){
+            queued[v].store(0, std::memory_order_relaxed);
+        }
+        std::size_t delta = 0;
+        for(std::size_t c : changed){
+            delta += c;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        result.iterations.push_back({static_cast<double>(delta), elapsed.count(), active});
+    }
+
+    result.converged = frontier.empty();
+    result.values.resize(n);
+    for(std::size_t v = 0; v < n; ++v){
+        result.values[v] = label[v].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef GraphBuilder_H
+#define GraphBuilder_H
+
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include "VertexInterner.h"
+
+// What Graph keeps when the same arc is loaded more than once. KeepMin matches
+// addEdge(); Reject makes the load throw std::invalid_argument instead.
+enum class DuplicateEdgePolicy { KeepMin, KeepFirst, KeepLast, Sum, Reject };
+
+// An arc between interned vertex ids, in load order.
+struct BulkArc {
+    uint32_t u, v;
+    int w;
+};
+
+// Collects vertices and edges (all at once or streamed in one by one) and
+// hands them to Graph in a single bulk load:
+//     GraphBuilder<int> builder(true, true);
+//     builder.reserve(vertexCount, edgeCount);
+//     for(...) builder.addEdge(u, v, w);
+//     Graph<int> graph(std::move(builder), DuplicateEdgePolicy::KeepMin);
+// Graph then counts degrees, reserves every adjacency map once and fills them
+// in parallel, instead of growing them edge by edge.
+template <typename T>
+class GraphBuilder {
+    private:
+        template <typename> friend class Graph;
+
+        VertexInterner<T> vertexIds;
+        std::vector<BulkArc> arcs;
+        bool isDirected;
+        bool isWeighted;
+        // integer vertices below directLimit skip the hash map after their first sighting
+        std::vector<uint32_t> directIds;
+        std::size_t directLimit;
+
+        uint32_t intern(const T& v){
+            if constexpr(std::is_integral<T>::value){
+                if(v >= 0 && static_cast<std::size_t>(v) < directLimit){
+                    std::size_t key = static_cast<std::size_t>(v);
+                    if(key >= directIds.size()){
+                        directIds.resize(std::min(directLimit, std::max(key + 1, 2 * directIds.size())), UINT32_MAX);
+                    }
+                    if(directIds[key] == UINT32_MAX){
+                        directIds[key] = vertexIds.intern(v);
+                    }
+                    return directIds[key];
+                }
+            }
+            return vertexIds.intern(v);
+        }
+
+    public:
+        GraphBuilder(bool isDirected = false, bool isWeighted = false)
+            : isDirected(isDirected), isWeighted(isWeighted), directLimit(std::size_t(1) << 22) {}
+
+        void reserve(std::size_t vertexCount, std::size_t edgeCount){
+            vertexIds.reserve(vertexCount);
+            arcs.reserve(edgeCount);
+            directLimit = std::max(directLimit, 4 * vertexCount);
+        }
+
+        void addVertex(const T& v) { intern(v); }
+
+        void addEdge(const T& u, const T& v, int w = 1){
+            if(!isWeighted){
+                w = 1;
+            }
+            uint32_t uid = intern(u);
+            arcs.push_back({uid, intern(v), w});
+        }
+
+        void addEdges(const std::vector<std::pair<T, T>>& edges){
+            arcs.reserve(arcs.size() + edges.size());
+            for(auto& [u, v] : edges){
+                addEdge(u, v, 1);
+            }
+        }
+
+        void addEdges(const std::vector<std::tuple<T, T, int>>& edges){
+            arcs.reserve(arcs.size() + edges.size());
+            for(auto& [u, v, w] : edges){
+                addEdge(u, v, w);
+            }
+        }
+
+        std::size_t getVertexCount() const { return vertexIds.size(); }
+        std::size_t getEdgeCount() const { return arcs.size(); } // as loaded, before duplicates are merged
+        bool directed() const { return isDirected; }
+        bool weighted() const { return isWeighted; }
+};
+
+#endif
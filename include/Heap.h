@@ -0,0 +1,198 @@
+#ifndef Heap_H
+#define Heap_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <climits>
+#include <cstdint>
+
+// Min-priority queues keyed by int over dense uint32_t ids, used by the
+// Dijkstra engines. All three share push(key, id) / pop() / empty():
+//  - LazyBinaryHeap pushes a new entry on every decrease, pop() may return
+//    stale entries that the caller skips
+//  - IndexedDaryHeap keeps one entry per id and decreases it in place
+//  - RadixHeap is monotone: keys must be non-negative and never smaller than
+//    the last popped key
+enum class HeapType { LazyBinary, IndexedDary, Radix };
+
+class LazyBinaryHeap {
+    private:
+        std::vector<std::pair<int, uint32_t>> heap;
+
+    public:
+        LazyBinaryHeap() {}
+        explicit LazyBinaryHeap(std::size_t reserve) { heap.reserve(reserve); }
+
+        bool empty() const { return heap.empty(); }
+        std::size_t size() const { return heap.size(); }
+        void clear() { heap.clear(); }
+        const std::pair<int, uint32_t>& top() const { return heap.front(); }
+
+        void push(int key, uint32_t id){
+            heap.push_back({key, id});
+            std::size_t i = heap.size() - 1;
+            while(i > 0){
+                std::size_t parent = (i - 1) / 2;
+                if(heap[parent] <= heap[i]){
+                    break;
+                }
+                std::swap(heap[parent], heap[i]);
+                i = parent;
+            }
+        }
+
+        std::pair<int, uint32_t> pop(){
+            std::pair<int, uint32_t> top = heap.front();
+            heap.front() = heap.back();
+            heap.pop_back();
+            std::size_t i = 0, n = heap.size();
+            while(true){
+                std::size_t smallest = i, left = 2 * i + 1, right = left + 1;
+                if(left < n && heap[left] < heap[smallest]){
+                    smallest = left;
+                }
+                if(right < n && heap[right] < heap[smallest]){
+                    smallest = right;
+                }
+                if(smallest == i){
+                    break;
+                }
+                std::swap(heap[i], heap[smallest]);
+                i = smallest;
+            }
+            return top;
+        }
+};
+
+template <unsigned D = 4>
+class IndexedDaryHeap {
+    private:
+        static constexpr uint32_t npos = UINT32_MAX;
+        std::vector<uint32_t> heap;     // ids in heap order
+        std::vector<uint32_t> position; // id -> index in heap, npos if absent
+        std::vector<int> keys;          // id -> current key
+
+        void siftUp(std::size_t i){
+            uint32_t id = heap[i];
+            while(i > 0){
+                std::size_t parent = (i - 1) / D;
+                if(keys[heap[parent]] <= keys[id]){
+                    break;
+                }
+                heap[i] = heap[parent];
+                position[heap[i]] = static_cast<uint32_t>(i);
+                i = parent;
+            }
+            heap[i] = id;
+            position[id] = static_cast<uint32_t>(i);
+        }
+
+        void siftDown(std::size_t i){
+            uint32_t id = heap[i];
+            std::size_t n = heap.size();
+            while(true){
+                std::size_t first = D * i + 1;
+                if(first >= n){
+                    break;
+                }
+                std::size_t best = first, last = std::min(first + D, n);
+                for(std::size_t c = first + 1; c < last; ++c){
+                    if(keys[heap[c]] < keys[heap[best]]){
+                        best = c;
+                    }
+                }
+                if(keys[heap[best]] >= keys[id]){
+                    break;
+                }
+                heap[i] = heap[best];
+                position[heap[i]] = static_cast<uint32_t>(i);
+                i = best;
+            }
+            heap[i] = id;
+            position[id] = static_cast<uint32_t>(i);
+        }
+
+    public:
+        explicit IndexedDaryHeap(std::size_t capacity) : position(capacity, npos), keys(capacity, INT_MAX) {}
+
+        bool empty() const { return heap.empty(); }
+        std::size_t size() const { return heap.size(); }
+        bool contains(uint32_t id) const { return position[id] != npos; }
+
+        // inserts id, or lowers its key if it is already queued with a larger one
+        void push(int key, uint32_t id){
+            if(position[id] == npos){
+                keys[id] = key;
+                heap.push_back(id);
+                siftUp(heap.size() - 1);
+            }
+            else if(key < keys[id]){
+                keys[id] = key;
+                siftUp(position[id]);
+            }
+        }
+
+        std::pair<int, uint32_t> pop(){
+            uint32_t top = heap.front();
+            position[top] = npos;
+            uint32_t last = heap.back();
+            heap.pop_back();
+            if(!heap.empty()){
+                heap.front() = last;
+                siftDown(0);
+            }
+            return {keys[top], top};
+        }
+};
+
+class RadixHeap {
+    private:
+        std::vector<std::pair<uint32_t, uint32_t>> buckets[33];
+        uint32_t last;
+        std::size_t count;
+
+        static unsigned bucketIndex(uint32_t key, uint32_t last){
+            return key == last ? 0 : 32 - __builtin_clz(key ^ last);
+        }
+
+    public:
+        RadixHeap() : last(0), count(0) {}
+
+        bool empty() const { return count == 0; }
+        std::size_t size() const { return count; }
+
+        void push(int key, uint32_t id){
+            if(key < 0 || static_cast<uint32_t>(key) < last){
+                throw std::invalid_argument("Radix heap keys must be non-negative and monotone");
+            }
+            buckets[bucketIndex(static_cast<uint32_t>(key), last)].push_back({static_cast<uint32_t>(key), id});
+            count++;
+        }
+
+        std::pair<int, uint32_t> pop(){
+            if(buckets[0].empty()){
+                unsigned i = 1;
+                while(buckets[i].empty()){
+                    i++;
+                }
+                // everything in bucket i moves to a strictly lower bucket
+                uint32_t smallest = UINT32_MAX;
+                for(auto &entry : buckets[i]){
+                    smallest = std::min(smallest, entry.first);
+                }
+                last = smallest;
+                for(auto &entry : buckets[i]){
+                    buckets[bucketIndex(entry.first, last)].push_back(entry);
+                }
+                buckets[i].clear();
+            }
+            std::pair<uint32_t, uint32_t> top = buckets[0].back();
+            buckets[0].pop_back();
+            count--;
+            return {static_cast<int>(top.first), top.second};
+        }
+};
+
+#endif
@@ -0,0 +1,538 @@
+#ifndef MappedGraph_H
+#define MappedGraph_H
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <queue>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Heap.h"
+#include "CsrGraph.h"
+
+template <typename T>
+class Graph;
+
+// On-disk layout (version 1, native byte order, every section 8-byte aligned):
+//   MappedGraphHeader
+//   vertex table     T[V] for trivially copyable T; for std::string
+//                    uint64 offsets[V + 1] followed by the characters
+//   vertex index     uint32[V], ids sorted by vertex value, for lookups
+//   offsets          uint64[V + 1]
+//   neighbors        uint32[E]
+//   weights          int32[E]
+//   in-offsets       uint64[V + 1]  (directed graphs only)
+//   in-neighbors     uint32[E]      (directed graphs only)
+// Section positions are stored as byte offsets from the start of the file.
+struct MappedGraphHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t vertexCount;
+    uint64_t arcCount;
+    uint64_t vertexSize; // sizeof(T), 0 for std::string
+    uint64_t vertexTable;
+    uint64_t vertexIndex;
+    uint64_t offsets;
+    uint64_t neighbors;
+    uint64_t weights;
+    uint64_t inOffsets;
+    uint64_t inNeighbors;
+    uint64_t fileSize;
+};
+
+// How vertex values are laid out in the vertex table.
+template <typename T>
+struct MappedVertexCodec {
+    static_assert(std::is_trivially_copyable<T>::value, "vertex type must be trivially copyable or std::string");
+    typedef const T& View;
+    static constexpr uint64_t size = sizeof(T);
+
+    static void write(std::ostream &out, const std::vector<T> &vertices){
+        out.write(reinterpret_cast<const char*>(vertices.data()), static_cast<std::streamsize>(vertices.size() * sizeof(T)));
+    }
+    // whether a table of n values fits in the available bytes
+    static bool validTable(const char*, uint64_t n, uint64_t available) { return n <= available / sizeof(T); }
+    static View get(const char *table, uint64_t, uint32_t id) { return reinterpret_cast<const T*>(table)[id]; }
+    static T copy(View v) { return v; }
+};
+
+template <>
+struct MappedVertexCodec<std::string> {
+    typedef std::string_view View;
+    static constexpr uint64_t size = 0;
+
+    static void write(std::ostream &out, const std::vector<std::string> &vertices){
+        uint64_t position = 0;
+        for(auto &v : vertices){
+            out.write(reinterpret_cast<const char*>(&position), sizeof(position));
+            position += v.size();
+        }
+        out.write(reinterpret_cast<const char*>(&position), sizeof(position));
+        for(auto &v : vertices){
+            out.write(v.data(), static_cast<std::streamsize>(v.size()));
+        }
+    }
+    // the offsets must fit, rise monotonically and end inside the available bytes
+    static bool validTable(const char *table, uint64_t n, uint64_t available){
+        if(n + 1 > available / sizeof(uint64_t)){
+            return false;
+        }
+        const uint64_t *offsets = reinterpret_cast<const uint64_t*>(table);
+        if(offsets[0] != 0 || offsets[n] > available - (n + 1) * sizeof(uint64_t)){
+            return false;
+        }
+        for(uint64_t i = 0; i < n; ++i){
+            if(offsets[i] > offsets[i + 1]){
+                return false;
+            }
+        }
+        return true;
+    }
+    static View get(const char *table, uint64_t n, uint32_t id){
+        const uint64_t *offsets = reinterpret_cast<const uint64_t*>(table);
+        const char *chars = table + (n + 1) * sizeof(uint64_t);
+        return std::string_view(chars + offsets[id], offsets[id + 1] - offsets[id]);
+    }
+    static std::string copy(View v) { return std::string(v); }
+};
+
+// Read-only graph served straight from a memory-mapped file written by
+// MappedGraph<T>::write (or writeBinary below). Opening validates the
+// header and scans the arrays once; after that they are used in place and
+// shared between processes mapping the same file. Vertex ids match the CsrGraph the file was written from. Lookups by
+// value binary search the sorted vertex index, so T needs operator<.
+template <typename T>
+class MappedGraph {
+    private:
+        static constexpr uint32_t formatVersion = 1;
+        static constexpr uint32_t directedFlag = 1, weightedFlag = 2, negativeFlag = 4;
+        typedef MappedVertexCodec<T> Codec;
+
+        void *base;
+        std::size_t length;
+        const MappedGraphHeader *header;
+        const char *vertexTable;
+        const uint32_t *vertexIndex;
+        const uint64_t *offsets;
+        const uint32_t *neighbors;
+        const int32_t *weights;
+        const uint64_t *inOffsets;
+        const uint32_t *inNeighbors;
+
+        static const char* magic() { return "GRAPHCSR"; }
+        static void pad(std::ostream &out);
+        template <typename U>
+        static void writeArray(std::ostream &out, const U *data, std::size_t count, uint64_t &section);
+        void validate() const;
+        void release();
+        template <typename Heap>
+        void runDijkstra(uint32_t start, std::vector<int> &distance, Heap &pq) const;
+
+    public:
+        // prefault maps with MAP_POPULATE, trading open latency for no page faults later
+        explicit MappedGraph(const std::string &path, bool prefault = false);
+        ~MappedGraph() { release(); }
+        MappedGraph(const MappedGraph&) = delete;
+        MappedGraph& operator=(const MappedGraph&) = delete;
+        MappedGraph(MappedGraph &&other) noexcept;
+        MappedGraph& operator=(MappedGraph &&other) noexcept;
+
+        // writes to path.tmp and renames it over path, so readers never see a partial file
+        static void write(const CsrGraph<T> &graph, const std::string &path);
+
+        std::size_t getVertexCount() const { return header->vertexCount; }
+        std::size_t getEdgeCount() const { return header->arcCount; } // number of stored arcs
+        bool directed() const { return header->flags & directedFlag; }
+        bool weighted() const { return header->flags & weightedFlag; }
+        bool hasVertex(const T &v) const;
+        uint32_t getId(const T &v) const;
+        typename Codec::View getVertex(uint32_t id) const { return Codec::get(vertexTable, header->vertexCount, id); }
+
+        // the mapped CSR arrays, same layout as CsrGraph's
+        const uint64_t* getOffsets() const { return offsets; }
+        const uint32_t* getNeighbors() const { return neighbors; }
+        const int32_t* getWeights() const { return weights; }
+        const uint64_t* getInOffsets() const { return directed() ? inOffsets : offsets; }
+        const uint32_t* getInNeighbors() const { return directed() ? inNeighbors : neighbors; }
+        std::size_t getDegree(uint32_t id) const { return offsets[id + 1] - offsets[id]; }
+
+        std::vector<T> getBFS(const T &start) const;
+        // BFS or Dijkstra on the mapped arrays; negative weights go through a CsrGraph copy
+        std::vector<std::pair<T, int>> getSinglePointShortestPath(const T &start, HeapType heap = HeapType::LazyBinary) const;
+        CsrGraph<T> toCsrGraph() const; // copies everything into memory
+};
+
+template <typename T>
+MappedGraph<T>::MappedGraph(const std::string &path, bool prefault) : base(MAP_FAILED), length(0), header(nullptr){
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0){
+        throw std::runtime_error("Cannot open graph file " + path);
+    }
+    struct stat info;
+    if(::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(MappedGraphHeader)){
+        ::close(fd);
+        throw std::runtime_error("Not a graph file " + path);
+    }
+    length = static_cast<std::size_t>(info.st_size);
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    if(prefault){
+        flags |= MAP_POPULATE;
+    }
+#endif
+    base = ::mmap(nullptr, length, PROT_READ, flags, fd, 0);
+    ::close(fd);
+    if(base == MAP_FAILED){
+        throw std::runtime_error("Cannot map graph file " + path);
+    }
+
+    const char *bytes = static_cast<const char*>(base);
+    header = reinterpret_cast<const MappedGraphHeader*>(bytes);
+    try{
+        validate();
+    }
+    catch(...){
+        release();
+        throw;
+    }
+    vertexTable = bytes + header->vertexTable;
+    vertexIndex = reinterpret_cast<const uint32_t*>(bytes + header->vertexIndex);
+    offsets = reinterpret_cast<const uint64_t*>(bytes + header->offsets);
+    neighbors = reinterpret_cast<const uint32_t*>(bytes + header->neighbors);
+    weights = reinterpret_cast<const int32_t*>(bytes + header->weights);
+    inOffsets = reinterpret_cast<const uint64_t*>(bytes + header->inOffsets);
+    inNeighbors = reinterpret_cast<const uint32_t*>(bytes + header->inNeighbors);
+}
+
+// Checks everything a query will read, so a corrupt file fails here rather
+// than in a later lookup: section bounds (sizes compared by division, so a
+// corrupt count cannot wrap them), then the vertex index, the offsets, the
+// neighbour ids and the sign of the weights.
+template <typename T>
+void MappedGraph<T>::validate() const{
+    if(std::memcmp(header->magic, magic(), sizeof(header->magic)) != 0 || header->version != formatVersion){
+        throw std::runtime_error("Not a graph file");
+    }
+    if(header->fileSize != length || header->vertexSize != Codec::size){
+        throw std::runtime_error("Graph file does not match this vertex type or is truncated");
+    }
+    const uint64_t n = header->vertexCount, m = header->arcCount;
+    const bool isDirected = header->flags & directedFlag;
+    auto inside = [this](uint64_t section, uint64_t count, uint64_t size){
+        return section % 8 == 0 && section <= length && count <= (length - section) / size;
+    };
+    const char *bytes = static_cast<const char*>(base);
+    // ids are uint32, and n + 1 offsets must not wrap
+    bool ok = n <= UINT32_MAX
+        && header->vertexTable % 8 == 0 && header->vertexTable <= length
+        && Codec::validTable(bytes + header->vertexTable, n, length - header->vertexTable)
+        && inside(header->vertexIndex, n, sizeof(uint32_t))
+        && inside(header->offsets, n + 1, sizeof(uint64_t))
+        && inside(header->neighbors, m, sizeof(uint32_t))
+        && inside(header->weights, m, sizeof(int32_t));
+    if(ok && isDirected){
+        ok = inside(header->inOffsets, n + 1, sizeof(uint64_t)) && inside(header->inNeighbors, m, sizeof(uint32_t));
+    }
+    if(!ok){
+        throw std::runtime_error("Corrupt graph file");
+    }
+
+    auto validIds = [n](const uint32_t *ids, uint64_t count){
+        for(uint64_t i = 0; i < count; ++i){
+            if(ids[i] >= n){
+                return false;
+            }
+        }
+        return true;
+    };
+    auto validOffsets = [n, m](const uint64_t *offsets){
+        if(offsets[0] != 0 || offsets[n] != m){
+            return false;
+        }
+        for(uint64_t i = 0; i < n; ++i){
+            if(offsets[i] > offsets[i + 1]){
+                return false;
+            }
+        }
+        return true;
+    };
+    ok = validIds(reinterpret_cast<const uint32_t*>(bytes + header->vertexIndex), n)
+        && validOffsets(reinterpret_cast<const uint64_t*>(bytes + header->offsets))
+        && validIds(reinterpret_cast<const uint32_t*>(bytes + header->neighbors), m);
+    if(ok && isDirected){
+        ok = validOffsets(reinterpret_cast<const uint64_t*>(bytes + header->inOffsets))
+            && validIds(reinterpret_cast<const uint32_t*>(bytes + header->inNeighbors), m);
+    }
+    if(ok && !(header->flags & negativeFlag)){
+        // the mapped Dijkstra trusts this flag
+        const int32_t *w = reinterpret_cast<const int32_t*>(bytes + header->weights);
+        for(uint64_t e = 0; e < m && ok; ++e){
+            ok = w[e] >= 0;
+        }
+    }
+    if(!ok){
+        throw std::runtime_error("Corrupt graph file");
+    }
+}
+
+template <typename T>
+void MappedGraph<T>::release(){
+    if(base != MAP_FAILED){
+        ::munmap(base, length);
+        base = MAP_FAILED;
+    }
+}
+
+template <typename T>
+MappedGraph<T>::MappedGraph(MappedGraph &&other) noexcept
+    : base(other.base), length(other.length), header(other.header), vertexTable(other.vertexTable),
+      vertexIndex(other.vertexIndex), offsets(other.offsets), neighbors(other.neighbors), weights(other.weights),
+      inOffsets(other.inOffsets), inNeighbors(other.inNeighbors){
+    other.base = MAP_FAILED;
+}
+
+template <typename T>
+MappedGraph<T>& MappedGraph<T>::operator=(MappedGraph &&other) noexcept{
+    if(this != &other){
+        release();
+        base = other.base;
+        length = other.length;
+        header = other.header;
+        vertexTable = other.vertexTable;
+        vertexIndex = other.vertexIndex;
+        offsets = other.offsets;
+        neighbors = other.neighbors;
+        weights = other.weights;
+        inOffsets = other.inOffsets;
+        inNeighbors = other.inNeighbors;
+        other.base = MAP_FAILED;
+    }
+    return *this;
+}
+
+template <typename T>
+void MappedGraph<T>::pad(std::ostream &out){
+    static const char zeros[8] = {};
+    std::streamoff position = out.tellp();
+    out.write(zeros, (8 - position % 8) % 8);
+}
+
+template <typename T>
+template <typename U>
+void MappedGraph<T>::writeArray(std::ostream &out, const U *data, std::size_t count, uint64_t &section){
+    pad(out);
+    section = static_cast<uint64_t>(out.tellp());
+    out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(U)));
+}
+
+template <typename T>
+void MappedGraph<T>::write(const CsrGraph<T> &graph, const std::string &path){
+    const std::vector<T> &vertices = graph.getVertices();
+    const uint64_t n = vertices.size(), m = graph.getEdgeCount();
+
+    MappedGraphHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, magic(), sizeof(h.magic));
+    h.version = formatVersion;
+    h.flags = (graph.directed() ? directedFlag : 0) | (graph.weighted() ? weightedFlag : 0);
+    for(int w : graph.getWeights()){
+        if(w < 0){
+            h.flags |= negativeFlag;
+            break;
+        }
+    }
+    h.vertexCount = n;
+    h.arcCount = m;
+    h.vertexSize = Codec::size;
+
+    std::vector<uint32_t> index(n);
+    for(uint32_t i = 0; i < n; ++i){
+        index[i] = i;
+    }
+    std::sort(index.begin(), index.end(), [&vertices](uint32_t a, uint32_t b){ return vertices[a] < vertices[b]; });
+    std::vector<uint64_t> offsets(graph.getOffsets().begin(), graph.getOffsets().end());
+    std::vector<uint64_t> inOffsets(graph.getInOffsets().begin(), graph.getInOffsets().end());
+    std::vector<int32_t> weights(graph.getWeights().begin(), graph.getWeights().end());
+
+    std::string temporary = path + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if(!out){
+        throw std::runtime_error("Cannot write graph file " + path);
+    }
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    pad(out);
+    h.vertexTable = static_cast<uint64_t>(out.tellp());
+    Codec::write(out, vertices);
+    writeArray(out, index.data(), n, h.vertexIndex);
+    writeArray(out, offsets.data(), n + 1, h.offsets);
+    writeArray(out, graph.getNeighbors().data(), m, h.neighbors);
+    writeArray(out, weights.data(), m, h.weights);
+    if(graph.directed()){
+        writeArray(out, inOffsets.data(), n + 1, h.inOffsets);
+        writeArray(out, graph.getInNeighbors().data(), m, h.inNeighbors);
+    }
+    pad(out);
+    h.fileSize = static_cast<uint64_t>(out.tellp());
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.close();
+    if(!out || std::rename(temporary.c_str(), path.c_str()) != 0){
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Cannot write graph file " + path);
+    }
+}
+
+template <typename T>
+bool MappedGraph<T>::hasVertex(const T &v) const{
+    const uint32_t *last = vertexIndex + header->vertexCount;
+    const uint32_t *it = std::lower_bound(vertexIndex, last, v, [this](uint32_t id, const T &value){
+        return getVertex(id) < value;
+    });
+    return it != last && !(v < getVertex(*it));
+}
+
+template <typename T>
+uint32_t MappedGraph<T>::getId(const T &v) const{
+    const uint32_t *last = vertexIndex + header->vertexCount;
+    const uint32_t *it = std::lower_bound(vertexIndex, last, v, [this](uint32_t id, const T &value){
+        return getVertex(id) < value;
+    });
+    if(it == last || v < getVertex(*it)){
+        throw std::invalid_argument("Vertex not found");
+    }
+    return *it;
+}
+
+template <typename T>
+std::vector<T> MappedGraph<T>::getBFS(const T &start) const{
+    uint32_t source = getId(start);
+    std::vector<bool> seen(header->vertexCount, false);
+    std::vector<uint32_t> order = {source};
+    seen[source] = true;
+    for(std::size_t head = 0; head < order.size(); ++head){
+        uint32_t u = order[head];
+        for(uint64_t e = offsets[u]; e < offsets[u + 1]; ++e){
+            if(!seen[neighbors[e]]){
+                seen[neighbors[e]] = true;
+                order.push_back(neighbors[e]);
+            }
+        }
+    }
+    std::vector<T> bfs;
+    bfs.reserve(order.size());
+    for(uint32_t id : order){
+        bfs.push_back(Codec::copy(getVertex(id)));
+    }
+    return bfs;
+}
+
+template <typename T>
+std::vector<std::pair<T, int>> MappedGraph<T>::getSinglePointShortestPath(const T &start, HeapType heap) const{
+    if(header->flags & negativeFlag){
+        return toCsrGraph().getSinglePointShortestPath(start, heap);
+    }
+
+    const uint32_t n = static_cast<uint32_t>(header->vertexCount);
+    uint32_t source = getId(start);
+    std::vector<int> distance(n, INT_MAX);
+    distance[source] = 0;
+    if(!weighted()){
+        std::queue<uint32_t> q;
+        q.push(source);
+        while(!q.empty()){
+            uint32_t u = q.front();
+            q.pop();
+            for(uint64_t e = offsets[u]; e < offsets[u + 1]; ++e){
+                if(distance[neighbors[e]] == INT_MAX){
+                    distance[neighbors[e]] = distance[u] + 1;
+                    q.push(neighbors[e]);
+                }
+            }
+        }
+    }
+    else{
+        switch(heap){
+            case HeapType::IndexedDary: {
+                IndexedDaryHeap<4> pq(n);
+                runDijkstra(source, distance, pq);
+                break;
+            }
+            case HeapType::Radix: {
+                RadixHeap pq;
+                runDijkstra(source, distance, pq);
+                break;
+            }
+            default: {
+                LazyBinaryHeap pq;
+                runDijkstra(source, distance, pq);
+                break;
+            }
+        }
+    }
+
+    std::vector<std::pair<T, int>> disVector;
+    disVector.reserve(n);
+    for(uint32_t id = 0; id < n; ++id){
+        disVector.push_back({Codec::copy(getVertex(id)), distance[id] == INT_MAX ? -1 : distance[id]});
+    }
+    return disVector;
+}
+
+template <typename T>
+template <typename Heap>
+void MappedGraph<T>::runDijkstra(uint32_t start, std::vector<int> &distance, Heap &pq) const{
+    pq.push(0, start);
+    while(!pq.empty()){
+        auto [dis, u] = pq.pop();
+        if(dis > distance[u]){
+            continue; // stale entry
+        }
+        for(uint64_t e = offsets[u]; e < offsets[u + 1]; ++e){
+            uint32_t v = neighbors[e];
+            if(dis + weights[e] < distance[v]){
+                distance[v] = dis + weights[e];
+                pq.push(distance[v], v);
+            }
+        }
+    }
+}
+
+template <typename T>
+CsrGraph<T> MappedGraph<T>::toCsrGraph() const{
+    const uint32_t n = static_cast<uint32_t>(header->vertexCount);
+    std::vector<T> vertices;
+    vertices.reserve(n);
+    for(uint32_t id = 0; id < n; ++id){
+        vertices.push_back(Codec::copy(getVertex(id)));
+    }
+    std::vector<std::pair<T, std::pair<T, int>>> edges;
+    edges.reserve(header->arcCount);
+    for(uint32_t u = 0; u < n; ++u){
+        for(uint64_t e = offsets[u]; e < offsets[u + 1]; ++e){
+            edges.push_back({vertices[u], {vertices[neighbors[e]], weights[e]}});
+        }
+    }
+    return CsrGraph<T>(vertices, edges, directed(), weighted());
+}
+
+// binary snapshot of graph that MappedGraph<T> can map back in without
+// parsing; kept out of Graph.h so only users of the file format pull in mmap
+template <typename T>
+void writeBinary(const Graph<T> &graph, const std::string &path){
+    MappedGraph<T>::write(graph.freeze(), path);
+}
+
+#endif
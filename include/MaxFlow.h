@@ -0,0 +1,404 @@
+#ifndef MaxFlow_H
+#define MaxFlow_H
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <climits>
+#include <cstdint>
+#include "CsrGraph.h"
+
+// Max-flow engines: Dinic's blocking flows, or highest-label push-relabel
+// with global relabeling and the gap heuristic (usually the faster one).
+enum class MaxFlowAlgorithm { Dinic, PushRelabel };
+
+// Edge weights are capacities. flows lists every arc carrying flow as
+// {u, {v, flow}}; on undirected graphs only the net direction of each edge.
+// sourceSide is the source half of a minimum cut (everything still reachable
+// from the source in the residual graph) and cutEdges the saturated arcs
+// leaving it, whose capacities add up to value.
+template <typename T>
+struct MaxFlowResult {
+    long long value = 0;
+    std::vector<std::pair<T, std::pair<T, long long>>> flows;
+    std::vector<T> sourceSide;
+    std::vector<std::pair<T, T>> cutEdges;
+};
+
+// Residual graph of a CsrGraph snapshot in flat arrays: the residual arcs of
+// vertex u are slots first[u] .. first[u+1], slot s points at head[s] and its
+// reverse arc is mate[s]. A directed arc becomes a forward slot plus a
+// reverse slot of capacity 0; an undirected edge becomes two slots that are
+// each other's reverse, both with the edge's capacity. The topology is built
+// once, every query works on its own copy of the capacities, so one MaxFlow
+// can serve concurrent queries.
+template <typename T>
+class MaxFlow {
+    private:
+        const CsrGraph<T> &graph;
+        std::vector<std::size_t> first;
+        std::vector<uint32_t> head;
+        std::vector<std::size_t> mate;
+        std::vector<long long> capacity;  // initial residual capacity per slot
+        std::vector<std::size_t> arcSlot; // snapshot arc -> its forward slot, SIZE_MAX if skipped
+
+        long long runDinic(uint32_t source, uint32_t sink, std::vector<long long> &residual) const;
+        long long runPushRelabel(uint32_t source, uint32_t sink, std::vector<long long> &residual) const;
+
+    public:
+        explicit MaxFlow(const CsrGraph<T> &graph);
+
+        MaxFlowResult<T> getMaxFlow(T source, T sink, MaxFlowAlgorithm algorithm = MaxFlowAlgorithm::PushRelabel) const;
+};
+
+template <typename T>
+MaxFlow<T>::MaxFlow(const CsrGraph<T> &graph) : graph(graph){
+    const std::size_t n = graph.getVertexCount();
+    const std::vector<std::size_t> &offsets = graph.getOffsets();
+    const std::vector<uint32_t> &neighbors = graph.getNeighbors();
+    const std::vector<int> &weights = graph.getWeights();
+    const bool undirected = !graph.directed();
+
+    // undirected edges are stored both ways; only the u < v copy makes slots
+    auto keep = [&](uint32_t u, uint32_t v){ return u != v && (!undirected || u < v); };
+
+    first.assign(n + 1, 0);
+    for(uint32_t u = 0; u < n; ++u){
+        for(std::size_t e = offsets[u]; e < offsets[u + 1]; ++e){
+            if(weights[e] < 0){
+                throw std::invalid_argument("Capacities must be non-negative");
+            }
+            uint32_t v = neighbors[e];
+            if(keep(u, v)){
+                first[u + 1]++;
+                first[v + 1]++;
+            }
+        }
+    }
+    for(std::size_t u = 0; u < n; ++u){
+        first[u + 1] += first[u];
+    }
+
+    head.resize(first[n]);
+    mate.resize(first[n]);
+    capacity.assign(first[n], 0);
+    arcSlot.assign(neighbors.size(), SIZE_MAX);
+    std::vector<std::size_t> cursor(first.begin(), first.end() - 1);
+    for(uint32_t u = 0; u < n; ++u){
+        for(std::size_t e = offsets[u]; e < offsets[u + 1]; ++e){
+            uint32_t v = neighbors[e];
+            if(!keep(u, v)){
+                continue;
+            }
+            std::size_t a = cursor[u]++, b = cursor[v]++;
+            head[a] = v;
+            head[b] = u;
+            mate[a] = b;
+            mate[b] = a;
+            capacity[a] = weights[e];
+            capacity[b] = undirected ? weights[e] : 0;
+            arcSlot[e] = a;
+        }
+    }
+}
+
+// Each phase layers the residual graph by BFS distance from the source, then
+// saturates it with an iterative DFS that remembers, per vertex, the first
+// arc that may still lead to the sink.
+template <typename T>
+long long MaxFlow<T>::runDinic(uint32_t source, uint32_t sink, std::vector<long long> &residual) const{
+    const uint32_t n = static_cast<uint32_t>(graph.getVertexCount());
+    std::vector<int> level(n);
+    std::vector<std::size_t> current(n);
+    std::vector<uint32_t> queue;
+    std::vector<std::size_t> path; // slots from source to u
+    long long flow = 0;
+
+    while(true){
+        std::fill(level.begin(), level.end(), -1);
+        level[source] = 0;
+        queue.assign(1, source);
+        for(std::size_t i = 0; i < queue.size() && level[sink] == -1; ++i){
+            uint32_t u = queue[i];
+            for(std::size_t s = first[u]; s < first[u + 1]; ++s){
+                if(residual[s] > 0 && level[head[s]] == -1){
+                    level[head[s]] = level[u] + 1;
+                    queue.push_back(head[s]);
+                }
+            }
+        }
+        if(level[sink] == -1){
+            return flow;
+        }
+
+        std::copy(first.begin(), first.end() - 1, current.begin());
+        path.clear();
+        uint32_t u = source;
+        while(true){
+            if(u == sink){
+                long long push = LLONG_MAX;
+                for(std::size_t s : path){
+                    push = std::min(push, residual[s]);
+                }
+                std::size_t keep = path.size();
+                for(std::size_t i = 0; i < path.size(); ++i){
+                    residual[path[i]] -= push;
+                    residual[mate[path[i]]] += push;
+                    if(residual[path[i]] == 0 && keep == path.size()){
+                        keep = i;
+                    }
+                }
+                flow += push;
+                // resume from the tail of the first arc that ran dry
+                path.resize(keep);
+                u = path.empty() ? source : head[path.back()];
+                continue;
+            }
+
+            std::size_t &s = current[u];
+            while(s < first[u + 1] && !(residual[s] > 0 && level[head[s]] == level[u] + 1)){
+                s++;
+            }
+            if(s < first[u + 1]){
+                path.push_back(s);
+                u = head[s];
+                continue;
+            }
+            // dead end: retreat and never come back this phase
+            if(u == source){
+                break;
+            }
+            level[u] = -1;
+            path.pop_back();
+            u = path.empty() ? source : head[path.back()];
+            current[u]++;
+        }
+    }
+}
+
+// Highest-label push-relabel in two phases. The first only discharges vertices
+// below height n and ends with a maximum preflow, whose sink excess is the
+// flow value. The second sends the excess stranded above n back to the source
+// so every arc carries a valid flow. Heights are periodically recomputed
+// exactly by reverse BFS from the sink (and then the source), and a height
+// below n that empties lifts everything above it straight to n.
+template <typename T>
+long long MaxFlow<T>::runPushRelabel(uint32_t source, uint32_t sink, std::vector<long long> &residual) const{
+    const uint32_t n = static_cast<uint32_t>(graph.getVertexCount());
+    const uint32_t unlabeled = 2 * n;
+    std::vector<uint32_t> height(n, 0);
+    std::vector<long long> excess(n, 0);
+    std::vector<std::size_t> current(n);
+    std::vector<std::vector<uint32_t>> active(2 * n + 1);
+    std::vector<std::vector<uint32_t>> level(n); // vertices per height below n, for the gap test
+    std::vector<std::size_t> levelIndex(n);
+    std::vector<uint32_t> queue;
+    uint32_t highest = 0, highestLevel = 0;
+    std::size_t work = 0;
+    const std::size_t relabelPeriod = 6 * std::size_t(n) + head.size();
+
+    auto addToLevel = [&](uint32_t v){
+        if(height[v] < n){
+            levelIndex[v] = level[height[v]].size();
+            level[height[v]].push_back(v);
+            highestLevel = std::max(highestLevel, height[v]);
+        }
+    };
+    auto removeFromLevel = [&](uint32_t v){
+        if(height[v] < n){
+            std::vector<uint32_t> &members = level[height[v]];
+            uint32_t last = members.back();
+            members[levelIndex[v]] = last;
+            levelIndex[last] = levelIndex[v];
+            members.pop_back();
+        }
+    };
+    auto activate = [&](uint32_t v){
+        active[height[v]].push_back(v);
+        highest = std::max(highest, height[v]);
+    };
+
+    auto globalRelabel = [&](){
+        std::fill(height.begin(), height.end(), unlabeled);
+        for(auto &members : level){
+            members.clear();
+        }
+        for(auto &bucket : active){
+            bucket.clear();
+        }
+        highest = highestLevel = 0;
+        height[sink] = 0;
+        height[source] = n;
+        for(uint32_t root : {sink, source}){
+            queue.assign(1, root);
+            for(std::size_t i = 0; i < queue.size(); ++i){
+                uint32_t u = queue[i];
+                for(std::size_t s = first[u]; s < first[u + 1]; ++s){
+                    uint32_t v = head[s];
+                    if(height[v] == unlabeled && residual[mate[s]] > 0){
+                        height[v] = height[u] + 1;
+                        queue.push_back(v);
+                    }
+                }
+            }
+        }
+        for(uint32_t v = 0; v < n; ++v){
+            current[v] = first[v];
+            addToLevel(v);
+            if(v != source && v != sink && excess[v] > 0 && height[v] < unlabeled){
+                activate(v);
+            }
+        }
+        work = 0;
+    };
+
+    auto push = [&](uint32_t u, std::size_t s){
+        uint32_t v = head[s];
+        long long amount = std::min(excess[u], residual[s]);
+        residual[s] -= amount;
+        residual[mate[s]] += amount;
+        excess[u] -= amount;
+        if(excess[v] == 0 && v != source && v != sink){
+            activate(v);
+        }
+        excess[v] += amount;
+    };
+
+    auto relabel = [&](uint32_t u){
+        removeFromLevel(u);
+        uint32_t old = height[u], lowest = unlabeled;
+        for(std::size_t s = first[u]; s < first[u + 1]; ++s){
+            if(residual[s] > 0){
+                lowest = std::min(lowest, height[head[s]] + 1);
+            }
+        }
+        height[u] = lowest;
+        current[u] = first[u];
+        addToLevel(u);
+        work += first[u + 1] - first[u] + 12;
+
+        if(old < n && level[old].empty()){
+            // nothing above the gap can reach the sink any more
+            for(uint32_t h = old + 1; h <= highestLevel; ++h){
+                for(uint32_t w : level[h]){
+                    height[w] = n;
+                    current[w] = first[w];
+                }
+                level[h].clear();
+                for(uint32_t w : active[h]){
+                    active[n].push_back(w);
+                }
+                active[h].clear();
+            }
+            highestLevel = old;
+        }
+    };
+
+    auto discharge = [&](uint32_t u, uint32_t limit){
+        while(excess[u] > 0){
+            if(current[u] == first[u + 1]){
+                relabel(u);
+                if(height[u] >= limit){
+                    if(height[u] < unlabeled){
+                        active[height[u]].push_back(u); // parked for the next phase
+                    }
+                    return;
+                }
+                continue;
+            }
+            std::size_t s = current[u];
+            if(residual[s] > 0 && height[u] == height[head[s]] + 1){
+                push(u, s);
+            }
+            else{
+                current[u]++;
+            }
+        }
+    };
+
+    for(std::size_t s = first[source]; s < first[source + 1]; ++s){
+        excess[source] += residual[s];
+        push(source, s);
+    }
+    globalRelabel();
+
+    for(uint32_t limit : {n, unlabeled}){
+        if(limit == unlabeled){
+            globalRelabel();
+        }
+        while(true){
+            highest = std::min(highest, limit - 1);
+            while(highest > 0 && active[highest].empty()){
+                highest--;
+            }
+            if(active[highest].empty()){
+                break;
+            }
+            uint32_t u = active[highest].back();
+            active[highest].pop_back();
+            if(height[u] != highest || excess[u] == 0){
+                continue;
+            }
+            discharge(u, limit);
+            if(work > relabelPeriod){
+                globalRelabel();
+            }
+        }
+    }
+    return excess[sink];
+}
+
+template <typename T>
+MaxFlowResult<T> MaxFlow<T>::getMaxFlow(T source, T sink, MaxFlowAlgorithm algorithm) const{
+    uint32_t s = graph.getId(source), t = graph.getId(sink);
+    if(s == t){
+        throw std::invalid_argument("Source and sink must differ");
+    }
+
+    std::vector<long long> residual(capacity);
+    MaxFlowResult<T> result;
+    result.value = algorithm == MaxFlowAlgorithm::Dinic ? runDinic(s, t, residual) : runPushRelabel(s, t, residual);
+
+    const std::size_t n = graph.getVertexCount();
+    const std::vector<std::size_t> &offsets = graph.getOffsets();
+    const std::vector<uint32_t> &neighbors = graph.getNeighbors();
+    for(uint32_t u = 0; u < n; ++u){
+        for(std::size_t e = offsets[u]; e < offsets[u + 1]; ++e){
+            if(arcSlot[e] == SIZE_MAX){
+                continue;
+            }
+            long long flow = capacity[arcSlot[e]] - residual[arcSlot[e]];
+            if(flow > 0){
+                result.flows.push_back({graph.getVertex(u), {graph.getVertex(neighbors[e]), flow}});
+            }
+            else if(flow < 0){
+                result.flows.push_back({graph.getVertex(neighbors[e]), {graph.getVertex(u), -flow}});
+            }
+        }
+    }
+
+    std::vector<bool> reached(n, false);
+    std::vector<uint32_t> queue{s};
+    reached[s] = true;
+    for(std::size_t i = 0; i < queue.size(); ++i){
+        uint32_t u = queue[i];
+        result.sourceSide.push_back(graph.getVertex(u));
+        for(std::size_t slot = first[u]; slot < first[u + 1]; ++slot){
+            if(residual[slot] > 0 && !reached[head[slot]]){
+                reached[head[slot]] = true;
+                queue.push_back(head[slot]);
+            }
+        }
+    }
+    for(uint32_t u : queue){
+        for(std::size_t slot = first[u]; slot < first[u + 1]; ++slot){
+            if(capacity[slot] > 0 && !reached[head[slot]]){
+                result.cutEdges.push_back({graph.getVertex(u), graph.getVertex(head[slot])});
+            }
+        }
+    }
+    return result;
+}
+
+#endif
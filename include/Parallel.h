@@ -0,0 +1,94 @@
+#ifndef Parallel_H
+#define Parallel_H
+
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+// Minimal std::thread helpers shared by the multi-threaded graph engines.
+
+// 0 means "use every hardware thread"
+inline unsigned resolveThreadCount(unsigned threads){
+    if(threads == 0){
+        threads = std::thread::hardware_concurrency();
+    }
+    return threads == 0 ? 1 : threads;
+}
+
+// Calls fn(chunkBegin, chunkEnd, threadIndex) over [begin, end) in chunks of
+// `grain` items handed out dynamically, so skewed work (high degree vertices)
+// still balances. threadIndex is in [0, threads) and can index per-thread
+// buffers. Small ranges run inline on the calling thread.
+template <typename Fn>
+void parallelFor(std::size_t begin, std::size_t end, unsigned threads, std::size_t grain, Fn fn){
+    if(begin >= end){
+        return;
+    }
+    grain = std::max<std::size_t>(grain, 1);
+    std::size_t chunks = (end - begin + grain - 1) / grain;
+    threads = static_cast<unsigned>(std::min<std::size_t>(resolveThreadCount(threads), chunks));
+    if(threads <= 1){
+        fn(begin, end, 0u);
+        return;
+    }
+
+    std::atomic<std::size_t> next(begin);
+    auto worker = [&](unsigned tid){
+        while(true){
+            std::size_t lo = next.fetch_add(grain, std::memory_order_relaxed);
+            if(lo >= end){
+                break;
+            }
+            fn(lo, std::min(lo + grain, end), tid);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for(unsigned t = 1; t < threads; ++t){
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for(auto &th : pool){
+        th.join();
+    }
+}
+
+// Sorts [first, last) by sorting one slice per thread and then merging
+// neighbouring slices pairwise, each merge round in parallel.
+template <typename It, typename Compare>
+void parallelSort(It first, It last, unsigned threads, Compare comp){
+    std::size_t n = static_cast<std::size_t>(last - first);
+    threads = resolveThreadCount(threads);
+    if(threads <= 1 || n < 4096){
+        std::sort(first, last, comp);
+        return;
+    }
+
+    std::vector<std::size_t> bounds;
+    for(unsigned t = 0; t <= threads; ++t){
+        bounds.push_back(n * t / threads);
+    }
+    parallelFor(0, threads, threads, 1, [&](std::size_t lo, std::size_t hi, unsigned){
+        for(std::size_t t = lo; t < hi; ++t){
+            std::sort(first + bounds[t], first + bounds[t + 1], comp);
+        }
+    });
+
+    for(std::size_t width = 1; width < threads; width *= 2){
+        std::size_t merges = (threads + 2 * width - 1) / (2 * width);
+        parallelFor(0, merges, threads, 1, [&](std::size_t lo, std::size_t hi, unsigned){
+            for(std::size_t m = lo; m < hi; ++m){
+                std::size_t left = m * 2 * width;
+                std::size_t mid = std::min<std::size_t>(left + width, threads);
+                std::size_t right = std::min<std::size_t>(left + 2 * width, threads);
+                if(mid < right){
+                    std::inplace_merge(first + bounds[left], first + bounds[mid], first + bounds[right], comp);
+                }
+            }
+        });
+    }
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef TraversalContext_H
+#define TraversalContext_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+#include <cstdint>
+
+// Scratch state for one traversal over dense vertex ids. The visited set is
+// an array of epoch stamps, so starting a new traversal is O(1) (bump the
+// epoch) instead of clearing n flags, and the queue/stack buffers keep their
+// capacity between traversals. A context belongs to one query at a time.
+class TraversalContext {
+    private:
+        std::vector<uint32_t> stamp;
+        uint32_t epoch;
+
+    public:
+        std::vector<uint32_t> queue; // FIFO as a vector with a moving head
+        std::vector<uint32_t> stack;
+
+        TraversalContext() : epoch(0) {}
+
+        // forgets every visit and sizes the context for ids below n
+        void reset(std::size_t n){
+            if(stamp.size() < n){
+                stamp.resize(n, 0);
+            }
+            if(++epoch == 0){
+                std::fill(stamp.begin(), stamp.end(), 0);
+                epoch = 1;
+            }
+            queue.clear();
+            stack.clear();
+        }
+
+        bool visited(uint32_t id) const { return stamp[id] == epoch; }
+        void visit(uint32_t id) { stamp[id] = epoch; }
+        // marks id, returns false if it was already visited
+        bool tryVisit(uint32_t id){
+            if(stamp[id] == epoch){
+                return false;
+            }
+            stamp[id] = epoch;
+            return true;
+        }
+};
+
+// Hands out idle contexts to concurrent queries and takes them back when the
+// lease ends, so steady-state queries allocate nothing. Copying a pool gives
+// an empty one: contexts are scratch, not state.
+class TraversalContextPool {
+    private:
+        std::mutex mutex;
+        std::vector<std::unique_ptr<TraversalContext>> idle;
+
+    public:
+        class Lease {
+            private:
+                TraversalContextPool *pool;
+                std::unique_ptr<TraversalContext> context;
+
+            public:
+                Lease(TraversalContextPool *pool, std::unique_ptr<TraversalContext> context) : pool(pool), context(std::move(context)) {}
+                Lease(Lease &&other) noexcept = default;
+                Lease(const Lease&) = delete;
+                Lease& operator=(const Lease&) = delete;
+                ~Lease(){
+                    if(context){
+                        pool->release(std::move(context));
+                    }
+                }
+
+                TraversalContext& operator*() const { return *context; }
+                TraversalContext* operator->() const { return context.get(); }
+        };
+
+        TraversalContextPool() {}
+        TraversalContextPool(const TraversalContextPool&) {}
+        TraversalContextPool& operator=(const TraversalContextPool&) { return *this; }
+
+        Lease acquire(){
+            std::unique_ptr<TraversalContext> context;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if(!idle.empty()){
+                    context = std::move(idle.back());
+                    idle.pop_back();
+                }
+            }
+            if(!context){
+                context.reset(new TraversalContext());
+            }
+            return Lease(this, std::move(context));
+        }
+
+        void release(std::unique_ptr<TraversalContext> context){
+            std::lock_guard<std::mutex> lock(mutex);
+            idle.push_back(std::move(context));
+        }
+};
+
+#endif
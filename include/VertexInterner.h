@@ -0,0 +1,95 @@
+#ifndef VertexInterner_H
+#define VertexInterner_H
+
+#include <vector>
+#include <unordered_map>
+#include <stdexcept>
+#include <cstdint>
+
+// Assigns every vertex a dense 32-bit id the first time it is seen so that
+// algorithms can index plain vectors instead of hashing T on every access.
+// Ids of erased vertices are recycled by later inserts.
+template <typename T>
+class VertexInterner {
+    private:
+        std::unordered_map<T, uint32_t> ids;
+        std::vector<T> vertices;
+        std::vector<bool> alive;
+        std::vector<uint32_t> freeIds;
+
+    public:
+        VertexInterner() {}
+
+        uint32_t intern(const T& v);
+        void erase(const T& v);
+        void clear();
+        void reserve(std::size_t n);
+
+        bool contains(const T& v) const { return ids.find(v) != ids.end(); }
+        uint32_t getId(const T& v) const;
+        const T& getVertex(uint32_t id) const { return vertices[id]; }
+        bool isAlive(uint32_t id) const { return id < alive.size() && alive[id]; }
+        // one past the largest id handed out, the size for id-indexed vectors
+        uint32_t capacity() const { return static_cast<uint32_t>(vertices.size()); }
+        std::size_t size() const { return ids.size(); }
+};
+
+template <typename T>
+uint32_t VertexInterner<T>::intern(const T& v){
+    auto it = ids.find(v);
+    if(it != ids.end()){
+        return it->second;
+    }
+
+    uint32_t id;
+    if(!freeIds.empty()){
+        id = freeIds.back();
+        freeIds.pop_back();
+        vertices[id] = v;
+        alive[id] = true;
+    }
+    else{
+        id = static_cast<uint32_t>(vertices.size());
+        vertices.push_back(v);
+        alive.push_back(true);
+    }
+    ids.emplace(v, id);
+    return id;
+}
+
+template <typename T>
+void VertexInterner<T>::erase(const T& v){
+    auto it = ids.find(v);
+    if(it == ids.end()){
+        return;
+    }
+    alive[it->second] = false;
+    freeIds.push_back(it->second);
+    ids.erase(it);
+}
+
+template <typename T>
+void VertexInterner<T>::clear(){
+    ids.clear();
+    vertices.clear();
+    alive.clear();
+    freeIds.clear();
+}
+
+template <typename T>
+void VertexInterner<T>::reserve(std::size_t n){
+    ids.reserve(n);
+    vertices.reserve(n);
+    alive.reserve(n);
+}
+
+template <typename T>
+uint32_t VertexInterner<T>::getId(const T& v) const{
+    auto it = ids.find(v);
+    if(it == ids.end()){
+        throw std::invalid_argument("Vertex not found");
+    }
+    return it->second;
+}
+
+#endif
@@ -0,0 +1,297 @@
+#ifndef TestSupport_H
+#define TestSupport_H
+
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <random>
+#include <vector>
+#include "Graph.h"
+
+// Every engine is checked against the plain textbook algorithms below, run on
+// the arcs getEdges() reports, so the references never share code with the
+// library.
+
+inline int failures = 0;
+
+#define CHECK(condition) do{ \
+        if(!(condition)){ \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    }while(0)
+
+#define CHECK_THROWS(expression, exception) do{ \
+        bool thrown = false; \
+        try{ expression; }catch(const exception&){ thrown = true; } \
+        if(!thrown){ \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": expected " #exception " from " #expression << std::endl; \
+            ++failures; \
+        } \
+    }while(0)
+
+inline int report(const char *name){
+    if(failures == 0){
+        std::cout << name << ": all checks passed" << std::endl;
+        return 0;
+    }
+    std::cout << name << ": " << failures << " checks failed" << std::endl;
+    return 1;
+}
+
+// vertices 0..n-1 and m random edges; weights in [minWeight, maxWeight]
+inline Graph<int> randomGraph(std::mt19937 &rng, int n, int m, bool isDirected, bool isWeighted, int minWeight = 1, int maxWeight = 20){
+    Graph<int> g(isDirected, isWeighted);
+    for(int v = 0; v < n; ++v){
+        g.addVertex(v);
+    }
+    std::uniform_int_distribution<int> vertex(0, n - 1), weight(minWeight, maxWeight);
+    for(int i = 0; i < m; ++i){
+        int u = vertex(rng), v = vertex(rng);
+        if(u != v){
+            g.addEdge(u, v, weight(rng));
+        }
+    }
+    return g;
+}
+
+// random DAG: every edge goes from a lower to a higher vertex
+inline Graph<int> randomDag(std::mt19937 &rng, int n, int m, int minWeight, int maxWeight){
+    Graph<int> g(true, true);
+    for(int v = 0; v < n; ++v){
+        g.addVertex(v);
+    }
+    std::uniform_int_distribution<int> vertex(0, n - 1), weight(minWeight, maxWeight);
+    for(int i = 0; i < m; ++i){
+        int u = vertex(rng), v = vertex(rng);
+        if(u != v){
+            g.addEdge(std::min(u, v), std::max(u, v), weight(rng));
+        }
+    }
+    return g;
+}
+
+// adjacency of a Graph<int> whose vertices are 0..n-1, straight from getEdges()
+struct Reference {
+    int n;
+    std::vector<std::vector<std::pair<int, int>>> out;
+
+    explicit Reference(const Graph<int> &g) : n(static_cast<int>(g.getVertices().size())), out(n){
+        for(auto &[u, edge] : g.getEdges()){
+            out[u].push_back(edge);
+        }
+    }
+
+    // -1 where unreachable; false if a negative cycle is reachable
+    bool bellmanFord(int source, std::vector<long long> &distance) const{
+        const long long inf = LLONG_MAX;
+        distance.assign(n, inf);
+        distance[source] = 0;
+        for(int round = 0; round <= n; ++round){
+            bool changed = false;
+            for(int u = 0; u < n; ++u){
+                if(distance[u] == inf){
+                    continue;
+                }
+                for(auto &[v, w] : out[u]){
+                    if(distance[u] + w < distance[v]){
+                        distance[v] = distance[u] + w;
+                        changed = true;
+                    }
+                }
+            }
+            if(!changed){
+                for(auto &d : distance){
+                    if(d == inf){
+                        d = -1;
+                    }
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<int> hops(int source) const{
+        std::vector<int> distance(n, -1);
+        std::queue<int> q;
+        distance[source] = 0;
+        q.push(source);
+        while(!q.empty()){
+            int u = q.front();
+            q.pop();
+            for(auto &[v, w] : out[u]){
+                if(distance[v] == -1){
+                    distance[v] = distance[u] + 1;
+                    q.push(v);
+                }
+            }
+        }
+        return distance;
+    }
+
+    std::vector<std::vector<char>> reachability() const{
+        std::vector<std::vector<char>> reach(n);
+        for(int s = 0; s < n; ++s){
+            std::vector<int> distance = hops(s);
+            reach[s].resize(n);
+            for(int v = 0; v < n; ++v){
+                reach[s][v] = distance[v] != -1;
+            }
+        }
+        return reach;
+    }
+
+    bool hasArc(int u, int v) const{
+        for(auto &edge : out[u]){
+            if(edge.first == v){
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int weight(int u, int v) const{
+        for(auto &edge : out[u]){
+            if(edge.first == v){
+                return edge.second;
+            }
+        }
+        return INT_MAX;
+    }
+
+    // undirected components, skipping one vertex or one edge when asked
+    int components(int skipVertex = -1, std::pair<int, int> skipEdge = {-1, -1}) const{
+        std::vector<char> seen(n, 0);
+        int count = 0;
+        for(int s = 0; s < n; ++s){
+            if(seen[s] || s == skipVertex){
+                continue;
+            }
+            ++count;
+            std::vector<int> stack{s};
+            seen[s] = 1;
+            while(!stack.empty()){
+                int u = stack.back();
+                stack.pop_back();
+                for(auto &[v, w] : out[u]){
+                    bool skipped = (u == skipEdge.first && v == skipEdge.second) || (u == skipEdge.second && v == skipEdge.first);
+                    if(!seen[v] && v != skipVertex && !skipped){
+                        seen[v] = 1;
+                        stack.push_back(v);
+                    }
+                }
+            }
+        }
+        return count;
+    }
+
+    // weight of a minimum spanning forest, by Prim's O(V^2) from every unvisited vertex
+    long long spanningForestWeight() const{
+        std::vector<char> inTree(n, 0);
+        std::vector<long long> best(n, LLONG_MAX);
+        long long total = 0;
+        for(int root = 0; root < n; ++root){
+            if(inTree[root]){
+                continue;
+            }
+            best[root] = 0;
+            while(true){
+                int u = -1;
+                for(int v = 0; v < n; ++v){
+                    if(!inTree[v] && best[v] != LLONG_MAX && (u == -1 || best[v] < best[u])){
+                        u = v;
+                    }
+                }
+                if(u == -1){
+                    break;
+                }
+                inTree[u] = 1;
+                total += best[u];
+                for(auto &[v, w] : out[u]){
+                    if(!inTree[v] && w < best[v]){
+                        best[v] = w;
+                    }
+                }
+            }
+        }
+        return total;
+    }
+
+    // Edmonds-Karp on a capacity matrix
+    long long maxFlow(int source, int sink) const{
+        std::vector<std::vector<long long>> capacity(n, std::vector<long long>(n, 0));
+        for(int u = 0; u < n; ++u){
+            for(auto &[v, w] : out[u]){
+                capacity[u][v] += w;
+            }
+        }
+        long long flow = 0;
+        while(true){
+            std::vector<int> parent(n, -1);
+            parent[source] = source;
+            std::queue<int> q;
+            q.push(source);
+            while(!q.empty() && parent[sink] == -1){
+                int u = q.front();
+                q.pop();
+                for(int v = 0; v < n; ++v){
+                    if(parent[v] == -1 && capacity[u][v] > 0){
+                        parent[v] = u;
+                        q.push(v);
+                    }
+                }
+            }
+            if(parent[sink] == -1){
+                return flow;
+            }
+            long long push = LLONG_MAX;
+            for(int v = sink; v != source; v = parent[v]){
+                push = std::min(push, capacity[parent[v]][v]);
+            }
+            for(int v = sink; v != source; v = parent[v]){
+                capacity[parent[v]][v] -= push;
+                capacity[v][parent[v]] += push;
+            }
+            flow += push;
+        }
+    }
+};
+
+inline std::map<int, int> toMap(const std::vector<std::pair<int, int>> &distances){
+    return std::map<int, int>(distances.begin(), distances.end());
+}
+
+inline std::map<int, int> toMap(const std::vector<long long> &distances){
+    std::map<int, int> byVertex;
+    for(std::size_t v = 0; v < distances.size(); ++v){
+        byVertex[static_cast<int>(v)] = static_cast<int>(distances[v]);
+    }
+    return byVertex;
+}
+
+// every vertex exactly once and every arc pointing forward
+inline bool isTopologicalOrder(const Reference &ref, const std::vector<int> &order){
+    if(static_cast<int>(order.size()) != ref.n){
+        return false;
+    }
+    std::vector<int> position(ref.n, -1);
+    for(std::size_t i = 0; i < order.size(); ++i){
+        if(order[i] < 0 || order[i] >= ref.n || position[order[i]] != -1){
+            return false;
+        }
+        position[order[i]] = static_cast<int>(i);
+    }
+    for(int u = 0; u < ref.n; ++u){
+        for(auto &[v, w] : ref.out[u]){
+            if(position[u] >= position[v]){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,137 @@
+#include <cmath>
+#include <set>
+#include "TestSupport.h"
+#include "GraphAnalytics.h"
+
+// maximum flow, minimum cut and PageRank
+
+static void checkFlow(const Graph<int> &g, const Reference &ref, bool isDirected, int source, int sink){
+    long long expected = ref.maxFlow(source, sink);
+    for(MaxFlowAlgorithm algorithm : {MaxFlowAlgorithm::Dinic, MaxFlowAlgorithm::PushRelabel}){
+        MaxFlowResult<int> result = g.getMaxFlow(source, sink, algorithm);
+        CHECK(result.value == expected);
+
+        // capacities respected and flow conserved everywhere but at the ends
+        std::vector<long long> balance(ref.n, 0);
+        std::map<std::pair<int, int>, long long> carried;
+        for(auto &[u, arc] : result.flows){
+            long long capacity = 0;
+            for(auto &[v, w] : ref.out[u]){
+                capacity += v == arc.first ? w : 0;
+            }
+            CHECK(arc.second > 0 && arc.second <= capacity);
+            carried[{u, arc.first}] += arc.second;
+            balance[u] -= arc.second;
+            balance[arc.first] += arc.second;
+        }
+        if(!isDirected){
+            for(auto &[edge, flow] : carried){
+                CHECK(carried.count({edge.second, edge.first}) == 0);
+            }
+        }
+        for(int v = 0; v < ref.n; ++v){
+            long long expectedBalance = v == source ? -expected : v == sink ? expected : 0;
+            CHECK(balance[v] == expectedBalance);
+        }
+
+        // the cut separates source and sink and its capacity equals the flow
+        std::set<int> side(result.sourceSide.begin(), result.sourceSide.end());
+        CHECK(side.count(source) == 1 && side.count(sink) == 0);
+        long long cut = 0;
+        for(auto &[u, v] : result.cutEdges){
+            CHECK(side.count(u) == 1 && side.count(v) == 0);
+            cut += ref.weight(u, v);
+        }
+        CHECK(cut == expected);
+        long long crossing = 0;
+        for(int u : side){
+            for(auto &[v, w] : ref.out[u]){
+                crossing += side.count(v) ? 0 : w;
+            }
+        }
+        CHECK(crossing == expected);
+    }
+}
+
+static void testMaxFlow(){
+    std::mt19937 rng(47);
+    for(int round = 0; round < 30; ++round){
+        int n = 2 + round * 2;
+        bool isDirected = round % 3 != 0;
+        Graph<int> g = randomGraph(rng, n, 3 * n, isDirected, true, 0, 25);
+        Reference ref(g);
+        checkFlow(g, ref, isDirected, 0, n - 1);
+        checkFlow(g, ref, isDirected, n - 1, n / 2 == n - 1 ? 0 : n / 2);
+    }
+
+    Graph<int> negative(true, true);
+    negative.addEdge(1, 2, -1);
+    CHECK_THROWS(negative.getMaxFlow(1, 2), std::exception);
+    CHECK_THROWS(negative.getMaxFlow(1, 3), std::invalid_argument);
+}
+
+// power iteration with dangling mass spread over teleport
+static std::vector<double> referencePageRank(const Reference &ref, const std::vector<double> &teleport, double damping){
+    std::vector<double> rank = teleport, next(ref.n);
+    for(int iteration = 0; iteration < 1000; ++iteration){
+        double dangling = 0;
+        for(int u = 0; u < ref.n; ++u){
+            dangling += ref.out[u].empty() ? rank[u] : 0;
+        }
+        for(int v = 0; v < ref.n; ++v){
+            next[v] = (1 - damping + damping * dangling) * teleport[v];
+        }
+        for(int u = 0; u < ref.n; ++u){
+            for(auto &[v, w] : ref.out[u]){
+                next[v] += damping * rank[u] / ref.out[u].size();
+            }
+        }
+        rank.swap(next);
+    }
+    return rank;
+}
+
+static void testPageRank(){
+    std::mt19937 rng(53);
+    AnalyticsOptions options;
+    options.tolerance = 1e-12;
+    options.maxIterations = 1000;
+    options.threads = 2;
+    for(int round = 0; round < 10; ++round){
+        int n = 5 + round * 20;
+        Graph<int> g = randomGraph(rng, n, 2 * n, round % 2 == 0, false);
+        Reference ref(g);
+
+        std::vector<double> expected = referencePageRank(ref, std::vector<double>(n, 1.0 / n), options.damping);
+        std::vector<std::pair<int, double>> ranks = g.getPageRank(options);
+        CHECK(ranks.size() == static_cast<std::size_t>(n));
+        double total = 0;
+        for(auto &[v, rank] : ranks){
+            CHECK(std::fabs(rank - expected[v]) < 1e-8);
+            total += rank;
+        }
+        CHECK(std::fabs(total - 1) < 1e-8);
+
+        CsrGraph<int> csr = g.freeze();
+        AnalyticsResult<double> result = GraphAnalytics<int>(csr).getPageRank(options);
+        CHECK(result.converged);
+        CHECK(!result.iterations.empty());
+        for(uint32_t id = 0; id < result.values.size(); ++id){
+            CHECK(std::fabs(result.values[id] - expected[csr.getVertex(id)]) < 1e-8);
+        }
+
+        std::vector<double> teleport(n, 0);
+        teleport[0] = 0.75;
+        teleport[n - 1] = 0.25;
+        std::vector<double> personalized = referencePageRank(ref, teleport, options.damping);
+        for(auto &[v, rank] : g.getPersonalizedPageRank({{0, 3.0}, {n - 1, 1.0}}, options)){
+            CHECK(std::fabs(rank - personalized[v]) < 1e-8);
+        }
+    }
+}
+
+int main(){
+    testMaxFlow();
+    testPageRank();
+    return report("test_flow_analytics");
+}
@@ -0,0 +1,263 @@
+#include <fstream>
+#include <sstream>
+#include "TestSupport.h"
+#include "MappedGraph.h"
+
+// single source, point to point and all pairs distances of every engine
+
+static const HeapType heaps[] = {HeapType::LazyBinary, HeapType::IndexedDary, HeapType::Radix};
+
+static void checkSingleSource(const Graph<int> &g, const Reference &ref, int source){
+    std::vector<long long> expected;
+    CHECK(ref.bellmanFord(source, expected));
+    std::map<int, int> reference = toMap(expected);
+
+    CsrGraph<int> csr = g.freeze();
+    CompressedGraph<int> compressed = g.compress();
+    for(HeapType heap : heaps){
+        CHECK(toMap(g.getSinglePointShortestPath(source, heap)) == reference);
+        CHECK(toMap(csr.getSinglePointShortestPath(source, heap)) == reference);
+        CHECK(toMap(compressed.getSinglePointShortestPath(source, heap)) == reference);
+    }
+
+    bool nonNegative = true;
+    for(auto &[u, edge] : g.getEdges()){
+        nonNegative = nonNegative && edge.second >= 0;
+    }
+    if(nonNegative){
+        ShortestPathOptions options;
+        options.deltaStepping = true;
+        options.threads = 2;
+        CHECK(toMap(csr.getSinglePointShortestPath(source, options)) == reference);
+        options.delta = 3;
+        CHECK(toMap(g.getSinglePointShortestPath(source, options)) == reference);
+    }
+}
+
+static void testSingleSource(){
+    std::mt19937 rng(7);
+    for(int round = 0; round < 30; ++round){
+        int n = 2 + round * 3;
+        bool isDirected = round % 2 == 0, isWeighted = round % 3 != 0;
+        Graph<int> g = randomGraph(rng, n, 3 * n, isDirected, isWeighted);
+        Reference ref(g);
+        checkSingleSource(g, ref, round % n);
+        // unweighted graphs go through BFS
+        if(!isWeighted){
+            std::vector<int> hops = ref.hops(0);
+            std::map<int, int> expected = toMap(std::vector<long long>(hops.begin(), hops.end()));
+            CHECK(toMap(g.getParallelBFS(0, 2)) == expected);
+            CHECK(toMap(g.freeze().getParallelBFS(0, 2)) == expected);
+        }
+    }
+
+    // negative weights: topological relaxation on DAGs, Bellman-Ford otherwise
+    for(int round = 0; round < 20; ++round){
+        int n = 5 + round * 2;
+        Graph<int> dag = randomDag(rng, n, 3 * n, -15, 20);
+        checkSingleSource(dag, Reference(dag), 0);
+
+        Graph<int> g = randomGraph(rng, n, 2 * n, true, true, -2, 30);
+        Reference ref(g);
+        std::vector<long long> expected;
+        if(ref.bellmanFord(0, expected)){
+            checkSingleSource(g, ref, 0);
+            CHECK(g.getNegativeCycle(0).empty());
+        }else{
+            CHECK_THROWS(g.getSinglePointShortestPath(0), std::runtime_error);
+            CHECK_THROWS(g.freeze().getSinglePointShortestPath(0), std::runtime_error);
+            // the cycle is reported in one of its two directions
+            std::vector<int> cycle = g.getNegativeCycle(0);
+            CHECK(!cycle.empty());
+            long long forward = 0, backward = 0;
+            bool forwardArcs = true, backwardArcs = true;
+            for(std::size_t i = 0; i < cycle.size(); ++i){
+                int u = cycle[i], v = cycle[(i + 1) % cycle.size()];
+                forwardArcs = forwardArcs && ref.hasArc(u, v);
+                backwardArcs = backwardArcs && ref.hasArc(v, u);
+                forward += forwardArcs ? ref.weight(u, v) : 0;
+                backward += backwardArcs ? ref.weight(v, u) : 0;
+            }
+            CHECK((forwardArcs && forward < 0) || (backwardArcs && backward < 0));
+        }
+    }
+}
+
+static void testMultiSourceBFS(){
+    std::mt19937 rng(11);
+    for(int round = 0; round < 6; ++round){
+        int n = 50 + round * 40;
+        Graph<int> g = randomGraph(rng, n, 2 * n, round % 2 == 0, false);
+        Reference ref(g);
+        std::vector<int> sources;
+        for(int s = 0; s < n; s += 3){
+            sources.push_back(s);
+        }
+        std::vector<std::vector<int>> rows = g.getMultiSourceBFS(sources, 2);
+        CHECK(rows.size() == sources.size());
+        for(std::size_t i = 0; i < sources.size() && i < rows.size(); ++i){
+            CHECK(rows[i] == ref.hops(sources[i]));
+        }
+    }
+}
+
+static void checkPath(const Reference &ref, const std::pair<int, std::vector<int>> &result, int source, int target, long long expected){
+    CHECK(result.first == expected);
+    if(expected == -1){
+        CHECK(result.second.empty());
+        return;
+    }
+    CHECK(!result.second.empty() && result.second.front() == source && result.second.back() == target);
+    long long length = 0;
+    for(std::size_t i = 0; i + 1 < result.second.size(); ++i){
+        int u = result.second[i], v = result.second[i + 1];
+        CHECK(ref.hasArc(u, v));
+        length += ref.hasArc(u, v) ? ref.weight(u, v) : 0;
+    }
+    CHECK(length == expected);
+}
+
+static void testPointToPoint(){
+    std::mt19937 rng(13);
+    for(int round = 0; round < 16; ++round){
+        int n = 10 + round * 6;
+        bool isDirected = round % 2 == 0, isWeighted = round % 4 != 1;
+        Graph<int> g = randomGraph(rng, n, 2 * n, isDirected, isWeighted);
+        if(round % 4 == 2){
+            g.setReverseIndex(true);
+        }
+        Reference ref(g);
+        auto zero = [](const int&, const int&){ return 0; };
+        ContractionHierarchy<int> ch = g.buildContractionHierarchy();
+        for(int source = 0; source < n; source += 5){
+            std::vector<long long> expected;
+            ref.bellmanFord(source, expected);
+            for(int target = 0; target < n; target += 3){
+                checkPath(ref, g.getShortestPath(source, target), source, target, expected[target]);
+                checkPath(ref, g.getShortestPath(source, target, zero), source, target, expected[target]);
+                CHECK(ch.getDistance(source, target) == expected[target]);
+                checkPath(ref, ch.getShortestPath(source, target), source, target, expected[target]);
+            }
+        }
+    }
+}
+
+static void checkAllPairs(const Graph<int> &g){
+    Reference ref(g);
+    std::vector<std::vector<int>> expected(ref.n);
+    for(int s = 0; s < ref.n; ++s){
+        std::vector<long long> distance;
+        CHECK(ref.bellmanFord(s, distance));
+        expected[s].assign(distance.begin(), distance.end());
+    }
+    CHECK(g.getAllShortestPath(APSPAlgorithm::FloydWarshall, 2) == expected);
+    CHECK(g.getAllShortestPath(APSPAlgorithm::Johnson, 2) == expected);
+    CHECK(g.getAllShortestPath(APSPAlgorithm::Auto) == expected);
+}
+
+static void testAllPairs(){
+    std::mt19937 rng(17);
+    for(int round = 0; round < 12; ++round){
+        int n = 4 + round * 5;
+        checkAllPairs(randomGraph(rng, n, 3 * n, round % 2 == 0, true));
+        checkAllPairs(randomDag(rng, n, 3 * n, -20, 20));
+    }
+    // sparse and past Auto's Floyd-Warshall cutoff, so Auto runs Johnson
+    checkAllPairs(randomDag(rng, 300, 600, -10, 10));
+
+    // repeated relaxations of vertex 4 through 1, 2 and 3 are not a negative
+    // cycle; Johnson must count hops on the current path, not relaxations
+    Graph<int> dag(true, true);
+    dag.addEdge(1, 4, -1);
+    dag.addEdge(2, 4, -2);
+    dag.addEdge(3, 4, -3);
+    dag.addEdge(5, 1, -1001);
+    dag.addEdge(5, 2, -1002);
+    dag.addEdge(5, 3, -1003);
+    CHECK(dag.getAllShortestPath(APSPAlgorithm::Johnson) == dag.getAllShortestPath(APSPAlgorithm::FloydWarshall));
+
+    Graph<int> cycle(true, true);
+    cycle.addEdge(1, 2, 3);
+    cycle.addEdge(2, 3, -2);
+    cycle.addEdge(3, 1, -2);
+    CHECK_THROWS(cycle.getAllShortestPath(APSPAlgorithm::Johnson), std::runtime_error);
+    CHECK_THROWS(cycle.getAllShortestPath(APSPAlgorithm::FloydWarshall), std::runtime_error);
+}
+
+static void testMappedAndReordered(){
+    std::mt19937 rng(19);
+    const std::string path = "test_paths.graph";
+    for(int round = 0; round < 6; ++round){
+        int n = 30 + round * 20;
+        Graph<int> g = randomGraph(rng, n, 3 * n, round % 2 == 0, round != 3);
+        Reference ref(g);
+        writeBinary(g, path);
+        MappedGraph<int> mapped(path);
+        CHECK(mapped.getVertexCount() == static_cast<std::size_t>(n));
+        CHECK(mapped.getBFS(0) == g.freeze().getBFS(0));
+        std::vector<long long> expected;
+        ref.bellmanFord(0, expected);
+        for(HeapType heap : heaps){
+            CHECK(toMap(mapped.getSinglePointShortestPath(0, heap)) == toMap(expected));
+        }
+
+        for(ReorderStrategy strategy : {ReorderStrategy::ReverseCuthillMcKee, ReorderStrategy::DegreeDescending, ReorderStrategy::BFS}){
+            VertexOrdering ordering;
+            CsrGraph<int> reordered = g.freeze(strategy, &ordering);
+            CHECK(toMap(reordered.getSinglePointShortestPath(0)) == toMap(expected));
+            CHECK(toMap(g.compress(strategy).getSinglePointShortestPath(0)) == toMap(expected));
+        }
+    }
+    std::remove(path.c_str());
+}
+
+// engine choice follows the negative arcs the graph holds now, not ever held
+static void testNegativeWeightsRemoved(){
+    auto zero = [](const int&, const int&){ return 0; };
+    Graph<int> g(false, true);
+    g.addEdge(1, 2, 4);
+    g.addEdge(2, 3, 1);
+    g.addEdge(1, 3, -6);
+    // an undirected negative edge is a negative cycle
+    CHECK_THROWS(g.getSinglePointShortestPath(1), std::runtime_error);
+    CHECK_THROWS(g.getShortestPath(1, 3, zero), std::invalid_argument);
+    g.removeEdge(3, 1);
+    std::map<int, int> expected{{1, 0}, {2, 4}, {3, 5}};
+    CHECK(toMap(g.getSinglePointShortestPath(1)) == expected);
+    CHECK(g.getShortestPath(1, 3, zero).first == 5);
+    Graph<int> copy = g;
+    CHECK(toMap(copy.getSinglePointShortestPath(1)) == expected);
+
+    // a lighter parallel edge turns an existing arc negative
+    g.addEdge(2, 3, -1);
+    CHECK_THROWS(g.getSinglePointShortestPath(1), std::runtime_error);
+    g.removeVertex(3);
+    CHECK(toMap(g.getSinglePointShortestPath(1)) == (std::map<int, int>{{1, 0}, {2, 4}}));
+
+    Graph<int> directed(true, true);
+    directed.setReverseIndex(true);
+    directed.addEdge(1, 2, 3);
+    directed.addEdge(2, 2, -1);
+    directed.addEdge(4, 2, -2);
+    CHECK_THROWS(directed.getShortestPath(1, 2, zero), std::invalid_argument);
+    directed.removeVertex(4);
+    CHECK_THROWS(directed.getShortestPath(1, 2, zero), std::invalid_argument);
+    directed.removeVertex(2);
+    CHECK(directed.getShortestPath(1, 1, zero).first == 0);
+
+    // Sum can cancel a negative duplicate during a bulk load
+    GraphBuilder<int> builder(true, true);
+    builder.addEdges(std::vector<std::tuple<int, int, int>>{{1, 2, -3}, {1, 2, 5}, {2, 3, 1}});
+    Graph<int> loaded(std::move(builder), DuplicateEdgePolicy::Sum);
+    CHECK(loaded.getShortestPath(1, 3, zero).first == 3);
+}
+
+int main(){
+    testSingleSource();
+    testNegativeWeightsRemoved();
+    testMultiSourceBFS();
+    testPointToPoint();
+    testAllPairs();
+    testMappedAndReordered();
+    return report("test_paths");
+}
@@ -0,0 +1,206 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "TestSupport.h"
+#include "ConcurrentGraph.h"
+#include "EdgeListParser.h"
+#include "MappedGraph.h"
+
+// file formats, parsers, bulk loading and versioned snapshots
+
+static std::string readFile(const std::string &path){
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static void writeFile(const std::string &path, const std::string &bytes){
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), bytes.size());
+}
+
+static void testMappedGraph(){
+    std::mt19937 rng(59);
+    const std::string path = "test_storage.graph";
+
+    Graph<int> g = randomGraph(rng, 60, 200, true, true, -3, 20);
+    writeBinary(g, path);
+    {
+        MappedGraph<int> mapped(path);
+        CsrGraph<int> copy = mapped.toCsrGraph();
+        CHECK(copy.getVertices() == g.freeze().getVertices());
+        CHECK(copy.getNeighbors() == g.freeze().getNeighbors());
+        CHECK(copy.getWeights() == g.freeze().getWeights());
+        CHECK(mapped.directed() && mapped.weighted());
+    }
+
+    Graph<std::string> names(false, true);
+    names.addEdge("alpha", "beta", 3);
+    names.addEdge("beta", "gamma", 4);
+    names.addEdge("alpha", "gamma", 9);
+    writeBinary(names, path);
+    {
+        MappedGraph<std::string> mapped(path);
+        CHECK(mapped.hasVertex("gamma") && !mapped.hasVertex("delta"));
+        CHECK(mapped.getSinglePointShortestPath("alpha") == names.freeze().getSinglePointShortestPath("alpha"));
+    }
+
+    // out of range ids and offsets must be refused, not followed
+    writeBinary(g, path);
+    const std::string bytes = readFile(path);
+    MappedGraphHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    for(uint64_t section : {header.neighbors, header.offsets + 8, header.inNeighbors, header.vertexIndex}){
+        std::string corrupt = bytes;
+        std::memset(&corrupt[section], 0xFF, 4);
+        writeFile(path, corrupt);
+        CHECK_THROWS(MappedGraph<int> mapped(path), std::runtime_error);
+    }
+    writeFile(path, bytes.substr(0, bytes.size() / 2));
+    CHECK_THROWS(MappedGraph<int> mapped(path), std::runtime_error);
+    std::remove(path.c_str());
+    CHECK_THROWS(MappedGraph<int> mapped(path), std::runtime_error);
+}
+
+static void testContractionHierarchyFile(){
+    std::mt19937 rng(61);
+    Graph<int> g = randomGraph(rng, 40, 120, true, true);
+    ContractionHierarchy<int> ch = g.buildContractionHierarchy();
+    std::stringstream saved;
+    ch.save(saved);
+    const std::string bytes = saved.str();
+
+    std::stringstream in(bytes);
+    ContractionHierarchy<int> loaded = ContractionHierarchy<int>::load(in);
+    for(int s = 0; s < 40; s += 3){
+        for(int t = 0; t < 40; t += 7){
+            CHECK(loaded.getDistance(s, t) == ch.getDistance(s, t));
+        }
+    }
+
+    // every single byte flip either loads a consistent hierarchy or is refused
+    for(std::size_t i = 0; i < bytes.size(); i += 3){
+        std::string corrupt = bytes;
+        corrupt[i] = static_cast<char>(corrupt[i] ^ 0x5A);
+        std::stringstream corruptIn(corrupt);
+        try{
+            ContractionHierarchy<int> accepted = ContractionHierarchy<int>::load(corruptIn);
+            for(int s = 0; s < 40; s += 9){
+                accepted.getShortestPath(s, 39 - s);
+            }
+        }catch(const std::runtime_error&){
+        }catch(const std::invalid_argument&){
+        }
+    }
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 5));
+    CHECK_THROWS(ContractionHierarchy<int>::load(truncated), std::runtime_error);
+
+    Graph<int> negative(true, true);
+    negative.addEdge(1, 2, -1);
+    CHECK_THROWS(negative.buildContractionHierarchy(), std::invalid_argument);
+}
+
+template <typename T>
+static Graph<T> parse(const std::string &text, EdgeListFormat format, bool isDirected, bool isWeighted, std::size_t chunkSize = 64){
+    GraphBuilder<T> builder(isDirected, isWeighted);
+    std::istringstream in(text);
+    EdgeListParser<T>(format, chunkSize).parse(in, builder);
+    return Graph<T>(std::move(builder));
+}
+
+static void testEdgeListParser(){
+    // chunks much smaller than the input, so lines straddle chunk boundaries
+    std::mt19937 rng(67);
+    Graph<int> g = randomGraph(rng, 200, 600, true, true, -50, 50);
+    std::ostringstream text;
+    text << "# random graph\n% with both comment styles\n";
+    for(auto &[u, edge] : g.getEdges()){
+        text << u << (u % 2 ? "\t" : " ") << edge.first << "," << edge.second << (u % 3 ? "\n" : "\r\n");
+    }
+    Graph<int> parsed = parse<int>(text.str(), EdgeListFormat::EdgeList, true, true);
+    Reference expected(g), actual(parsed);
+    CHECK(parsed.getEdges().size() == g.getEdges().size());
+    for(int u = 0; u < 200; ++u){
+        for(auto &[v, w] : expected.out[u]){
+            CHECK(actual.weight(u, v) == w);
+        }
+    }
+
+    Graph<int> dimacs = parse<int>("c road network\np sp 4 3\na 1 2 5\na 2 3 -1\na 3 4 2\n", EdgeListFormat::Dimacs, true, true);
+    CHECK(toMap(dimacs.getSinglePointShortestPath(1)) == (std::map<int, int>{{1, 0}, {2, 5}, {3, 4}, {4, 6}}));
+    Graph<int> unweighted = parse<int>("1 2 7\n2 3 9\n", EdgeListFormat::EdgeList, false, false);
+    CHECK(toMap(unweighted.getSinglePointShortestPath(1)) == (std::map<int, int>{{1, 0}, {2, 1}, {3, 2}}));
+
+    CHECK_THROWS(parse<int>("1 x\n", EdgeListFormat::EdgeList, true, false), std::runtime_error);
+    CHECK_THROWS(parse<int>("1 2 99999999999\n", EdgeListFormat::EdgeList, true, true), std::runtime_error);
+    CHECK_THROWS(parse<int>("1 99999999999\n", EdgeListFormat::EdgeList, true, false), std::runtime_error);
+    CHECK_THROWS(parse<uint8_t>("1 300\n", EdgeListFormat::EdgeList, true, false), std::runtime_error);
+    CHECK_THROWS(parse<unsigned>("1 -2\n", EdgeListFormat::EdgeList, true, false), std::runtime_error);
+    CHECK_THROWS(parse<int>("p sp 99999999999 1\na 1 2 3\n", EdgeListFormat::Dimacs, true, true), std::runtime_error);
+    CHECK(parse<int8_t>("-128 127\n", EdgeListFormat::EdgeList, true, false).getEdges().size() == 1);
+}
+
+static void testBulkLoad(){
+    auto weightOf = [](DuplicateEdgePolicy policy){
+        GraphBuilder<int> builder(true, true);
+        builder.addEdges(std::vector<std::tuple<int, int, int>>{{1, 2, 5}, {1, 2, 3}, {1, 2, 4}, {2, 3, 1}});
+        Graph<int> g(std::move(builder), policy);
+        return toMap(g.getSinglePointShortestPath(1))[2];
+    };
+    CHECK(weightOf(DuplicateEdgePolicy::KeepMin) == 3);
+    CHECK(weightOf(DuplicateEdgePolicy::KeepFirst) == 5);
+    CHECK(weightOf(DuplicateEdgePolicy::KeepLast) == 4);
+    CHECK(weightOf(DuplicateEdgePolicy::Sum) == 12);
+    CHECK_THROWS(weightOf(DuplicateEdgePolicy::Reject), std::invalid_argument);
+
+    // a bulk load matches the same edges added one by one
+    std::mt19937 rng(71);
+    Graph<int> g = randomGraph(rng, 300, 1500, false, true);
+    GraphBuilder<int> builder(false, true);
+    for(int v = 0; v < 300; ++v){
+        builder.addVertex(v);
+    }
+    for(auto &[u, edge] : g.getEdges()){
+        builder.addEdge(u, edge.first, edge.second);
+    }
+    Graph<int> loaded(std::move(builder), DuplicateEdgePolicy::KeepMin, 2);
+    CHECK(toMap(loaded.getSinglePointShortestPath(0)) == toMap(g.getSinglePointShortestPath(0)));
+    CHECK(loaded.getAllShortestPath() == g.getAllShortestPath());
+}
+
+static void testConcurrentGraph(){
+    ConcurrentGraph<int> graph(true, true, 2);
+    CHECK(graph.getVersion() == 1);
+    uint64_t first = graph.addEdge(1, 2, 4);
+    ConcurrentGraph<int>::Snapshot before = graph.snapshot();
+    uint64_t second = graph.update([](Graph<int> &g){
+        g.addEdge(2, 3, 1);
+        g.addEdge(1, 3, 9);
+    });
+    CHECK(second == first + 1 && graph.getVersion() == second);
+    CHECK(before->getEdges().size() == 1);
+    CHECK(toMap(graph.snapshot()->getSinglePointShortestPath(1)) == (std::map<int, int>{{1, 0}, {2, 4}, {3, 5}}));
+
+    // a throwing batch publishes nothing
+    CHECK_THROWS(graph.update([](Graph<int> &g){
+        g.addEdge(5, 6, 1);
+        throw std::runtime_error("abort");
+    }), std::runtime_error);
+    CHECK(graph.getVersion() == second);
+    CHECK(!graph.snapshot()->getVertices().empty() && graph.snapshot()->getVertices().size() == 3);
+
+    graph.removeEdge(1, 2);
+    CHECK(graph.snapshot(first) == nullptr);
+    CHECK(graph.snapshot(second) != nullptr && graph.snapshot(second)->getEdges().size() == 3);
+    CHECK(before->getEdges().size() == 1);
+}
+
+int main(){
+    testMappedGraph();
+    testContractionHierarchyFile();
+    testEdgeListParser();
+    testBulkLoad();
+    testConcurrentGraph();
+    return report("test_storage");
+}
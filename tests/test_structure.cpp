@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <set>
+#include "TestSupport.h"
+#include "GraphAnalytics.h"
+
+// components, spanning trees, cut vertices and orders
+
+static void testStronglyConnectedComponents(){
+    std::mt19937 rng(23);
+    for(int round = 0; round < 20; ++round){
+        int n = 3 + round * 8;
+        Graph<int> g = randomGraph(rng, n, n + round * 4, true, true);
+        Reference ref(g);
+        std::vector<std::vector<char>> reach = ref.reachability();
+        for(SCCAlgorithm algorithm : {SCCAlgorithm::Tarjan, SCCAlgorithm::ForwardBackward}){
+            StronglyConnectedComponents scc = g.getStronglyConnectedComponents(algorithm, 2);
+            CHECK(scc.component.size() == static_cast<std::size_t>(n));
+            if(scc.component.size() != static_cast<std::size_t>(n)){
+                continue;
+            }
+            std::set<uint32_t> ids(scc.component.begin(), scc.component.end());
+            CHECK(ids.size() == scc.count);
+            CHECK(scc.condensation.getVertexCount() == scc.count);
+            for(int u = 0; u < n; ++u){
+                for(int v = 0; v < n; ++v){
+                    bool together = reach[u][v] && reach[v][u];
+                    CHECK(together == (scc.component[u] == scc.component[v]));
+                }
+                // components are numbered in topological order
+                for(auto &[v, w] : ref.out[u]){
+                    CHECK(scc.component[u] <= scc.component[v]);
+                }
+            }
+            CHECK(!scc.condensation.hasCycle());
+        }
+    }
+}
+
+static void testSpanningTrees(){
+    std::mt19937 rng(29);
+    for(int round = 0; round < 20; ++round){
+        int n = 2 + round * 7;
+        Graph<int> g = randomGraph(rng, n, n + round * 5, false, true, -5, 40);
+        Reference ref(g);
+        for(MSTAlgorithm algorithm : {MSTAlgorithm::Kruskal, MSTAlgorithm::Prim, MSTAlgorithm::Boruvka}){
+            auto tree = g.getMST(algorithm, 2);
+            long long total = 0;
+            for(auto &[u, edge] : tree){
+                CHECK(ref.weight(u, edge.first) == edge.second);
+                total += edge.second;
+            }
+            CHECK(total == ref.spanningForestWeight());
+            CHECK(static_cast<int>(tree.size()) == n - ref.components());
+        }
+    }
+}
+
+static void testBiconnectivity(){
+    std::mt19937 rng(31);
+    for(int round = 0; round < 20; ++round){
+        int n = 3 + round * 3;
+        Graph<int> g = randomGraph(rng, n, n + round % 5, false, false);
+        Reference ref(g);
+        Biconnectivity<int> result = g.getBiconnectivity();
+        int base = ref.components();
+
+        std::set<int> articulation(result.articulationPoints.begin(), result.articulationPoints.end());
+        CHECK(articulation.size() == result.articulationPoints.size());
+        for(int v = 0; v < n; ++v){
+            // removing v also removes its own component when it was isolated
+            bool isolated = ref.out[v].empty();
+            bool expected = ref.components(v) > base - (isolated ? 1 : 0);
+            CHECK(expected == (articulation.count(v) == 1));
+        }
+
+        std::set<std::pair<int, int>> bridges;
+        for(auto &[u, v] : result.bridges){
+            bridges.insert({std::min(u, v), std::max(u, v)});
+        }
+        CHECK(bridges.size() == result.bridges.size());
+        for(auto &[u, edge] : g.getEdges()){
+            int v = edge.first;
+            if(u < v){
+                bool expected = ref.components(-1, {u, v}) > base;
+                CHECK(expected == (bridges.count({u, v}) == 1));
+            }
+        }
+
+        // every non-isolated vertex is in a component, cut vertices in several
+        std::map<int, int> memberships;
+        for(auto &component : result.components){
+            for(int v : component){
+                memberships[v]++;
+            }
+        }
+        for(int v = 0; v < n; ++v){
+            int expected = ref.out[v].empty() ? 0 : articulation.count(v) ? 2 : 1;
+            CHECK(std::min(memberships[v], 2) == expected);
+        }
+    }
+    CHECK_THROWS(Graph<int>(true).getBiconnectivity(), std::exception);
+}
+
+static void testOrders(){
+    std::mt19937 rng(37);
+    for(int round = 0; round < 20; ++round){
+        int n = 2 + round * 5;
+        Graph<int> dag = randomDag(rng, n, 2 * n, 1, 5);
+        Reference ref(dag);
+        CHECK(!dag.hasCycle());
+        CHECK(isTopologicalOrder(ref, dag.getTopologicalOrderDFS()));
+        CHECK(isTopologicalOrder(ref, dag.getTopologicalOrderBFS()));
+        CHECK(isTopologicalOrder(ref, dag.freeze().getTopologicalOrderDFS()));
+        CHECK(isTopologicalOrder(ref, dag.freeze().getTopologicalOrderBFS()));
+
+        // a back edge closes a cycle
+        if(n > 2){
+            Graph<int> cyclic = dag;
+            cyclic.addEdge(n - 1, 0);
+            Reference cyclicRef(cyclic);
+            std::vector<std::vector<char>> reach = cyclicRef.reachability();
+            bool expected = false;
+            for(int u = 0; u < n; ++u){
+                for(auto &[v, w] : cyclicRef.out[u]){
+                    expected = expected || reach[v][u];
+                }
+            }
+            CHECK(cyclic.hasCycle() == expected);
+            CHECK(cyclic.freeze().hasCycle() == expected);
+        }
+    }
+
+    // the maintained order must stay valid across inserts
+    Graph<int> g(true);
+    g.setIncrementalTopologicalOrder(true);
+    for(int i = 0; i < 300; ++i){
+        int u = rng() % 60, v = rng() % 60;
+        if(u != v){
+            g.addEdge(std::min(u, v), std::max(u, v));
+        }
+        if(i % 50 == 0){
+            g.addVertex(100 + i);
+        }
+    }
+    std::vector<int> order = g.getTopologicalOrderDFS();
+    std::map<int, std::size_t> position;
+    for(std::size_t i = 0; i < order.size(); ++i){
+        position[order[i]] = i;
+    }
+    CHECK(order.size() == g.getVertices().size());
+    CHECK(position.size() == order.size());
+    for(auto &[u, edge] : g.getEdges()){
+        CHECK(position[u] < position[edge.first]);
+    }
+}
+
+static void testConnectivity(){
+    std::mt19937 rng(41);
+    for(ConnectivityMode mode : {ConnectivityMode::None, ConnectivityMode::InsertOnly, ConnectivityMode::Dynamic}){
+        Graph<int> g = randomGraph(rng, 80, 60, false, false);
+        g.enableConnectivityIndex(mode);
+        for(int step = 0; step < 200; ++step){
+            int u = rng() % 80, v = rng() % 80;
+            if(u == v){
+                continue;
+            }
+            if(step % 3 == 0){
+                g.removeEdge(u, v);
+            }else{
+                g.addEdge(u, v);
+            }
+            if(step % 10 == 0){
+                Reference ref(g);
+                CHECK(g.getComponentCount() == static_cast<std::size_t>(ref.components()));
+                std::vector<int> hops = ref.hops(u);
+                for(int w = 0; w < 80; ++w){
+                    CHECK(g.connected(u, w) == (hops[w] != -1));
+                }
+            }
+        }
+    }
+}
+
+static void testLabelPropagation(){
+    std::mt19937 rng(43);
+    for(int round = 0; round < 8; ++round){
+        int n = 20 + round * 30;
+        Graph<int> g = randomGraph(rng, n, n, false, false);
+        Reference ref(g);
+        CsrGraph<int> csr = g.freeze();
+        AnalyticsOptions options;
+        options.threads = 2;
+        options.maxIterations = n + 1;
+        AnalyticsResult<uint32_t> labels = GraphAnalytics<int>(csr).getLabelPropagationComponents(options);
+        CHECK(labels.converged);
+        CHECK(labels.values.size() == static_cast<std::size_t>(n));
+        for(int u = 0; u < n && labels.values.size() == static_cast<std::size_t>(n); ++u){
+            std::vector<int> hops = ref.hops(csr.getVertex(u));
+            for(int v = 0; v < n; ++v){
+                CHECK((labels.values[u] == labels.values[v]) == (hops[csr.getVertex(v)] != -1));
+            }
+        }
+    }
+}
+
+int main(){
+    testStronglyConnectedComponents();
+    testSpanningTrees();
+    testBiconnectivity();
+    testOrders();
+    testConnectivity();
+    testLabelPropagation();
+    return report("test_structure");
+}